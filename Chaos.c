@@ -26,6 +26,7 @@
 #include <stdbool.h>
 
 #include "interpreter/function.h"
+#include "interpreter/json.h"
 
 #ifdef CHAOS_COMPILER
 #   include "../Chaos.h"
@@ -287,13 +288,33 @@ enum ValueType getDictElementValueType(char *name, char *key) {
 }
 
 char* dumpVariableToString(char *name, bool pretty, bool escaped, bool double_quotes) {
+    size_t len;
+    return dumpVariableToStringWithLength(name, pretty, escaped, double_quotes, &len);
+}
+
+char* dumpVariableToStringWithLength(char *name, bool pretty, bool escaped, bool double_quotes, size_t *len) {
     Symbol* symbol = getSymbol(name);
     bool is_complex = false;
     if (symbol->type == K_LIST || symbol->type == K_DICT)
         is_complex = true;
-    char *encoded = NULL;
-    encoded = encodeSymbolValueToString(symbol, is_complex, pretty, escaped, 0, encoded, double_quotes);
-    return encoded;
+    cpu_output_buffer* previous = cpu_output_redirect(new_cpu_output_string());
+    streamSymbolValue(symbol, is_complex, pretty, escaped, 0, double_quotes);
+    cpu_output_buffer* buffer = cpu_output_redirect(previous);
+    *len = cpu_output_length(buffer);
+    return cpu_output_release_string(buffer);
+}
+
+size_t dumpVariableToStream(char *name, FILE *stream, bool pretty, bool escaped, bool double_quotes) {
+    Symbol* symbol = getSymbol(name);
+    bool is_complex = false;
+    if (symbol->type == K_LIST || symbol->type == K_DICT)
+        is_complex = true;
+    cpu_output_buffer* previous = cpu_output_redirect(new_cpu_output_stream(stream));
+    streamSymbolValue(symbol, is_complex, pretty, escaped, 0, double_quotes);
+    cpu_output_buffer* buffer = cpu_output_redirect(previous);
+    size_t len = cpu_output_length(buffer);
+    cpu_output_release_stream(buffer);
+    return len;
 }
 
 void returnVariableBool(bool b) {
@@ -399,6 +420,6 @@ void raiseError(char *msg) {
 }
 
 void parseJson(char *json) {
-    injectCode(json, INIT_JSON_PARSE);
-    phase = PROGRAM;
+    Symbol* symbol = parseJsonToSymbol(json, strlen(json));
+    returnVariable(symbol);
 }
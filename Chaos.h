@@ -23,6 +23,7 @@
 #ifndef KAOS_CHAOS_H
 #define KAOS_CHAOS_H
 
+#include <stdio.h>
 #include <stdbool.h>
 
 #if defined(CHAOS_INTERPRETER)
@@ -85,6 +86,8 @@ void copyDictElement(char *name, char *key);
 enum Type getDictElementType(char *name, char *key);
 enum ValueType getDictElementValueType(char *name, char *key);
 char* dumpVariableToString(char *name, bool pretty, bool escaped, bool double_quotes);
+char* dumpVariableToStringWithLength(char *name, bool pretty, bool escaped, bool double_quotes, size_t *len);
+size_t dumpVariableToStream(char *name, FILE *stream, bool pretty, bool escaped, bool double_quotes);
 void returnVariableBool(bool b);
 void returnVariableInt(long long i);
 void returnVariableFloat(double f);
@@ -176,6 +179,8 @@ struct Kaos {
     enum Role (*getRole)(char *name);
     void (*raiseError)(char *msg);
     void (*parseJson)(char *json);
+    char* (*dumpVariableToStringWithLength)(char *name, bool pretty, bool escaped, bool double_quotes, size_t *len);
+    size_t (*dumpVariableToStream)(char *name, FILE *stream, bool pretty, bool escaped, bool double_quotes);
 };
 
 struct Kaos kaos;
@@ -25,15 +25,36 @@
 extern bool interactively_importing;
 
 ASTRoot* _ast_root = NULL;
+__thread ParseContext* parse_context = NULL;
 
-AST* ast(int lineno)
+File* astCurrentFile()
 {
-    AST* ast = (struct AST*)calloc(1, sizeof(AST));
-    ast->lineno = lineno;
+    // The nodes belong to the file that is being parsed on this thread
+    if (parse_context != NULL)
+        return parse_context->file;
+
     File* file = _ast_root->files[_ast_root->file_count - 1];
     if (is_interactive && !interactively_importing)
         file = _ast_root->files[0];
+    return file;
+}
+
+void* astAlloc(size_t size)
+{
+    return astArenaAlloc(&astCurrentFile()->arena, size);
+}
+
+AST* ast(int lineno)
+{
+    // Location records are immutable, the nodes on the same line share one
+    File* file = astCurrentFile();
+    if (file->last_ast != NULL && file->last_ast->lineno == lineno)
+        return file->last_ast;
+
+    AST* ast = (struct AST*)astAlloc(sizeof(AST));
+    ast->lineno = lineno;
     ast->file = file;
+    file->last_ast = ast;
     return ast;
 }
 
@@ -42,7 +63,7 @@ AST* ast(int lineno)
 
 Expr* buildExpr(enum ExprKind kind, int lineno)
 {
-    Expr* expr = (struct Expr*)calloc(1, sizeof(Expr));
+    Expr* expr = (struct Expr*)astAlloc(sizeof(Expr));
     expr->ast = ast(lineno);
     expr->kind = kind;
     return expr;
@@ -52,7 +73,7 @@ Expr* basicLitBool(bool b, int lineno)
 {
     union Value value;
     value.b = b;
-    BasicLit* basic_lit = (struct BasicLit*)calloc(1, sizeof(BasicLit));
+    BasicLit* basic_lit = (struct BasicLit*)astAlloc(sizeof(BasicLit));
     basic_lit->value_type = V_BOOL;
     basic_lit->value = value;
     Expr* expr = buildExpr(BasicLit_kind, lineno);
@@ -64,7 +85,7 @@ Expr* basicLitInt(long long i, int lineno)
 {
     union Value value;
     value.i = i;
-    BasicLit* basic_lit = (struct BasicLit*)calloc(1, sizeof(BasicLit));
+    BasicLit* basic_lit = (struct BasicLit*)astAlloc(sizeof(BasicLit));
     basic_lit->value_type = V_INT;
     basic_lit->value = value;
     Expr* expr = buildExpr(BasicLit_kind, lineno);
@@ -76,7 +97,7 @@ Expr* basicLitFloat(double f, int lineno)
 {
     union Value value;
     value.f = f;
-    BasicLit* basic_lit = (struct BasicLit*)calloc(1, sizeof(BasicLit));
+    BasicLit* basic_lit = (struct BasicLit*)astAlloc(sizeof(BasicLit));
     basic_lit->value_type = V_FLOAT;
     basic_lit->value = value;
     Expr* expr = buildExpr(BasicLit_kind, lineno);
@@ -87,10 +108,9 @@ Expr* basicLitFloat(double f, int lineno)
 Expr* basicLitString(char *s, int lineno)
 {
     union Value value;
-    value.s = malloc(1 + strlen(s));
-    strcpy(value.s, s);
-    free(s);
-    BasicLit* basic_lit = (struct BasicLit*)calloc(1, sizeof(BasicLit));
+    // Interned by the lexer
+    value.s = s;
+    BasicLit* basic_lit = (struct BasicLit*)astAlloc(sizeof(BasicLit));
     basic_lit->value_type = V_STRING;
     basic_lit->value = value;
     Expr* expr = buildExpr(BasicLit_kind, lineno);
@@ -100,10 +120,9 @@ Expr* basicLitString(char *s, int lineno)
 
 Expr* ident(char *s, int lineno)
 {
-    Ident* ident = (struct Ident*)calloc(1, sizeof(Ident));
-    ident->name = malloc(1 + strlen(s));
-    strcpy(ident->name, s);
-    free(s);
+    Ident* ident = (struct Ident*)astAlloc(sizeof(Ident));
+    // Interned by the lexer
+    ident->name = s;
     Expr* expr = buildExpr(Ident_kind, lineno);
     expr->v.ident = ident;
     return expr;
@@ -111,7 +130,7 @@ Expr* ident(char *s, int lineno)
 
 Expr* binaryExpr(Expr* x, enum Token op, Expr* y, int lineno)
 {
-    BinaryExpr* binary_expr = (struct BinaryExpr*)calloc(1, sizeof(BinaryExpr));
+    BinaryExpr* binary_expr = (struct BinaryExpr*)astAlloc(sizeof(BinaryExpr));
     binary_expr->x = x;
     binary_expr->op = op;
     binary_expr->y = y;
@@ -122,7 +141,7 @@ Expr* binaryExpr(Expr* x, enum Token op, Expr* y, int lineno)
 
 Expr* unaryExpr(enum Token op, Expr* x, int lineno)
 {
-    UnaryExpr* unary_expr = (struct UnaryExpr*)calloc(1, sizeof(UnaryExpr));
+    UnaryExpr* unary_expr = (struct UnaryExpr*)astAlloc(sizeof(UnaryExpr));
     unary_expr->op = op;
     unary_expr->x = x;
     Expr* expr = buildExpr(UnaryExpr_kind, lineno);
@@ -132,7 +151,7 @@ Expr* unaryExpr(enum Token op, Expr* x, int lineno)
 
 Expr* parenExpr(Expr* x, int lineno)
 {
-    ParenExpr* paren_expr = (struct ParenExpr*)calloc(1, sizeof(ParenExpr));
+    ParenExpr* paren_expr = (struct ParenExpr*)astAlloc(sizeof(ParenExpr));
     paren_expr->x = x;
     Expr* expr = buildExpr(ParenExpr_kind, lineno);
     expr->v.paren_expr = paren_expr;
@@ -141,7 +160,7 @@ Expr* parenExpr(Expr* x, int lineno)
 
 Expr* incDecExpr(enum Token op, Expr* x, bool first, int lineno)
 {
-    IncDecExpr* incdec_expr = (struct IncDecExpr*)calloc(1, sizeof(IncDecExpr));
+    IncDecExpr* incdec_expr = (struct IncDecExpr*)astAlloc(sizeof(IncDecExpr));
     incdec_expr->op = op;
     incdec_expr->x = x;
     incdec_expr->first = first;
@@ -152,7 +171,7 @@ Expr* incDecExpr(enum Token op, Expr* x, bool first, int lineno)
 
 Expr* moduleSelector(Spec* parent_dir_spec, Expr* x, Expr* sel, int lineno)
 {
-    ModuleSelector* module_selector = (struct ModuleSelector*)calloc(1, sizeof(ModuleSelector));
+    ModuleSelector* module_selector = (struct ModuleSelector*)astAlloc(sizeof(ModuleSelector));
     module_selector->parent_dir_spec = parent_dir_spec;
     module_selector->x = x;
     module_selector->sel = sel;
@@ -163,7 +182,7 @@ Expr* moduleSelector(Spec* parent_dir_spec, Expr* x, Expr* sel, int lineno)
 
 Expr* aliasExpr(Expr* name, Expr* asname, int lineno)
 {
-    AliasExpr* alias_expr = (struct AliasExpr*)calloc(1, sizeof(AliasExpr));
+    AliasExpr* alias_expr = (struct AliasExpr*)astAlloc(sizeof(AliasExpr));
     alias_expr->name = name;
     alias_expr->asname = asname;
     Expr* expr = buildExpr(AliasExpr_kind, lineno);
@@ -173,7 +192,7 @@ Expr* aliasExpr(Expr* name, Expr* asname, int lineno)
 
 Expr* indexExpr(Expr* x, Expr* index, int lineno)
 {
-    IndexExpr* index_expr = (struct IndexExpr*)calloc(1, sizeof(IndexExpr));
+    IndexExpr* index_expr = (struct IndexExpr*)astAlloc(sizeof(IndexExpr));
     index_expr->x = x;
     index_expr->index = index;
     Expr* expr = buildExpr(IndexExpr_kind, lineno);
@@ -183,7 +202,7 @@ Expr* indexExpr(Expr* x, Expr* index, int lineno)
 
 Expr* compositeLit(Spec* type, ExprList* elts, int lineno)
 {
-    CompositeLit* composite_lit = (struct CompositeLit*)calloc(1, sizeof(CompositeLit));
+    CompositeLit* composite_lit = (struct CompositeLit*)astAlloc(sizeof(CompositeLit));
     composite_lit->type = type;
     composite_lit->elts = elts;
     Expr* expr = buildExpr(CompositeLit_kind, lineno);
@@ -193,7 +212,7 @@ Expr* compositeLit(Spec* type, ExprList* elts, int lineno)
 
 Expr* keyValueExpr(Expr* key, Expr* value, int lineno)
 {
-    KeyValueExpr* key_value_expr = (struct KeyValueExpr*)calloc(1, sizeof(KeyValueExpr));
+    KeyValueExpr* key_value_expr = (struct KeyValueExpr*)astAlloc(sizeof(KeyValueExpr));
     key_value_expr->key = key;
     key_value_expr->value = value;
     Expr* expr = buildExpr(KeyValueExpr_kind, lineno);
@@ -203,7 +222,7 @@ Expr* keyValueExpr(Expr* key, Expr* value, int lineno)
 
 Expr* selectorExpr(Expr* x, Expr* sel, int lineno)
 {
-    SelectorExpr* selector_expr = (struct SelectorExpr*)calloc(1, sizeof(SelectorExpr));
+    SelectorExpr* selector_expr = (struct SelectorExpr*)astAlloc(sizeof(SelectorExpr));
     selector_expr->x = x;
     selector_expr->sel = sel;
     Expr* expr = buildExpr(SelectorExpr_kind, lineno);
@@ -213,7 +232,7 @@ Expr* selectorExpr(Expr* x, Expr* sel, int lineno)
 
 Expr* callExpr(Expr* fun, ExprList* args, int lineno)
 {
-    CallExpr* call_expr = (struct CallExpr*)calloc(1, sizeof(CallExpr));
+    CallExpr* call_expr = (struct CallExpr*)astAlloc(sizeof(CallExpr));
     call_expr->fun = fun;
     call_expr->args = args;
     Expr* expr = buildExpr(CallExpr_kind, lineno);
@@ -223,7 +242,7 @@ Expr* callExpr(Expr* fun, ExprList* args, int lineno)
 
 Expr* decisionExpr(Expr* bool_expr, Stmt* outcome, int lineno)
 {
-    DecisionExpr* decision_expr = (struct DecisionExpr*)calloc(1, sizeof(DecisionExpr));
+    DecisionExpr* decision_expr = (struct DecisionExpr*)astAlloc(sizeof(DecisionExpr));
     decision_expr->bool_expr = bool_expr;
     decision_expr->outcome = outcome;
     Expr* expr = buildExpr(DecisionExpr_kind, lineno);
@@ -233,19 +252,30 @@ Expr* decisionExpr(Expr* bool_expr, Stmt* outcome, int lineno)
 
 Expr* defaultExpr(Stmt* outcome, int lineno)
 {
-    DefaultExpr* default_expr = (struct DefaultExpr*)calloc(1, sizeof(DefaultExpr));
+    DefaultExpr* default_expr = (struct DefaultExpr*)astAlloc(sizeof(DefaultExpr));
     default_expr->outcome = outcome;
     Expr* expr = buildExpr(DefaultExpr_kind, lineno);
     expr->v.default_expr = default_expr;
     return expr;
 }
 
+Expr* sliceExpr(Expr* x, Expr* low, Expr* high, int lineno)
+{
+    SliceExpr* slice_expr = (struct SliceExpr*)astAlloc(sizeof(SliceExpr));
+    slice_expr->x = x;
+    slice_expr->low = low;
+    slice_expr->high = high;
+    Expr* expr = buildExpr(SliceExpr_kind, lineno);
+    expr->v.slice_expr = slice_expr;
+    return expr;
+}
+
 
 // Stmt
 
 Stmt* buildStmt(enum StmtKind kind, int lineno)
 {
-    Stmt* stmt = (struct Stmt*)calloc(1, sizeof(Stmt));
+    Stmt* stmt = (struct Stmt*)astAlloc(sizeof(Stmt));
     stmt->ast = ast(lineno);
     stmt->kind = kind;
     return stmt;
@@ -253,7 +283,7 @@ Stmt* buildStmt(enum StmtKind kind, int lineno)
 
 Stmt* assignStmt(Expr* x, enum Token tok, Expr* y, int lineno)
 {
-    AssignStmt* assign_stmt = (struct AssignStmt*)calloc(1, sizeof(AssignStmt));
+    AssignStmt* assign_stmt = (struct AssignStmt*)astAlloc(sizeof(AssignStmt));
     assign_stmt->x = x;
     assign_stmt->tok = tok;
     assign_stmt->y = y;
@@ -264,7 +294,7 @@ Stmt* assignStmt(Expr* x, enum Token tok, Expr* y, int lineno)
 
 Stmt* returnStmt(Expr* x, int lineno)
 {
-    ReturnStmt* return_stmt = (struct ReturnStmt*)calloc(1, sizeof(ReturnStmt));
+    ReturnStmt* return_stmt = (struct ReturnStmt*)astAlloc(sizeof(ReturnStmt));
     return_stmt->x = x;
     return_stmt->dont_push_callx = false;
     Stmt* stmt = buildStmt(ReturnStmt_kind, lineno);
@@ -274,7 +304,7 @@ Stmt* returnStmt(Expr* x, int lineno)
 
 Stmt* printStmt(Spec* mod, Expr* x, int lineno)
 {
-    PrintStmt* print_stmt = (struct PrintStmt*)calloc(1, sizeof(PrintStmt));
+    PrintStmt* print_stmt = (struct PrintStmt*)astAlloc(sizeof(PrintStmt));
     print_stmt->mod = mod;
     print_stmt->x = x;
     Stmt* stmt = buildStmt(PrintStmt_kind, lineno);
@@ -284,7 +314,7 @@ Stmt* printStmt(Spec* mod, Expr* x, int lineno)
 
 Stmt* echoStmt(Spec* mod, Expr* x, int lineno)
 {
-    EchoStmt* echo_stmt = (struct EchoStmt*)calloc(1, sizeof(EchoStmt));
+    EchoStmt* echo_stmt = (struct EchoStmt*)astAlloc(sizeof(EchoStmt));
     echo_stmt->mod = mod;
     echo_stmt->x = x;
     Stmt* stmt = buildStmt(EchoStmt_kind, lineno);
@@ -294,7 +324,7 @@ Stmt* echoStmt(Spec* mod, Expr* x, int lineno)
 
 Stmt* exprStmt(Expr* x, int lineno)
 {
-    ExprStmt* expr_stmt = (struct ExprStmt*)calloc(1, sizeof(ExprStmt));
+    ExprStmt* expr_stmt = (struct ExprStmt*)astAlloc(sizeof(ExprStmt));
     expr_stmt->x = x;
     Stmt* stmt = buildStmt(ExprStmt_kind, lineno);
     stmt->v.expr_stmt = expr_stmt;
@@ -303,7 +333,7 @@ Stmt* exprStmt(Expr* x, int lineno)
 
 Stmt* declStmt(Decl* decl, int lineno)
 {
-    DeclStmt* decl_stmt = (struct DeclStmt*)calloc(1, sizeof(DeclStmt));
+    DeclStmt* decl_stmt = (struct DeclStmt*)astAlloc(sizeof(DeclStmt));
     decl_stmt->decl = decl;
     Stmt* stmt = buildStmt(DeclStmt_kind, lineno);
     stmt->v.decl_stmt = decl_stmt;
@@ -312,7 +342,7 @@ Stmt* declStmt(Decl* decl, int lineno)
 
 Stmt* delStmt(Expr* ident, int lineno)
 {
-    DelStmt* del_stmt = (struct DelStmt*)calloc(1, sizeof(DelStmt));
+    DelStmt* del_stmt = (struct DelStmt*)astAlloc(sizeof(DelStmt));
     del_stmt->ident = ident;
     Stmt* stmt = buildStmt(DelStmt_kind, lineno - 1);  // TODO: Why do we need `lineno - 1` here?
     stmt->v.del_stmt = del_stmt;
@@ -321,7 +351,7 @@ Stmt* delStmt(Expr* ident, int lineno)
 
 Stmt* exitStmt(Expr* x, int lineno)
 {
-    ExitStmt* exit_stmt = (struct ExitStmt*)calloc(1, sizeof(ExitStmt));
+    ExitStmt* exit_stmt = (struct ExitStmt*)astAlloc(sizeof(ExitStmt));
     exit_stmt->x = x;
     Stmt* stmt = buildStmt(ExitStmt_kind, lineno - 1);  // TODO: Why do we need `lineno - 1` here?
     stmt->v.exit_stmt = exit_stmt;
@@ -330,7 +360,7 @@ Stmt* exitStmt(Expr* x, int lineno)
 
 Stmt* functionTableStmt(int lineno)
 {
-    FunctionTableStmt* function_table_stmt = (struct FunctionTableStmt*)calloc(1, sizeof(FunctionTableStmt));
+    FunctionTableStmt* function_table_stmt = (struct FunctionTableStmt*)astAlloc(sizeof(FunctionTableStmt));
     function_table_stmt->kind = FunctionTableStmt_kind;
     Stmt* stmt = buildStmt(FunctionTableStmt_kind, lineno);
     stmt->v.function_table_stmt = function_table_stmt;
@@ -339,7 +369,7 @@ Stmt* functionTableStmt(int lineno)
 
 Stmt* blockStmt(StmtList* stmt_list, int lineno)
 {
-    BlockStmt* block_stmt = (struct BlockStmt*)calloc(1, sizeof(BlockStmt));
+    BlockStmt* block_stmt = (struct BlockStmt*)astAlloc(sizeof(BlockStmt));
     block_stmt->stmt_list = stmt_list;
     Stmt* stmt = buildStmt(BlockStmt_kind, lineno);
     stmt->v.block_stmt = block_stmt;
@@ -348,7 +378,7 @@ Stmt* blockStmt(StmtList* stmt_list, int lineno)
 
 Stmt* breakStmt(int lineno)
 {
-    BreakStmt* break_stmt = (struct BreakStmt*)calloc(1, sizeof(BreakStmt));
+    BreakStmt* break_stmt = (struct BreakStmt*)astAlloc(sizeof(BreakStmt));
     break_stmt->kind = BreakStmt_kind;
     Stmt* stmt = buildStmt(BreakStmt_kind, lineno);
     stmt->v.break_stmt = break_stmt;
@@ -360,7 +390,7 @@ Stmt* breakStmt(int lineno)
 
 Spec* buildSpec(enum SpecKind kind, int lineno)
 {
-    Spec* spec = (struct Spec*)calloc(1, sizeof(Spec));
+    Spec* spec = (struct Spec*)astAlloc(sizeof(Spec));
     spec->ast = ast(lineno);
     spec->kind = kind;
     return spec;
@@ -368,7 +398,7 @@ Spec* buildSpec(enum SpecKind kind, int lineno)
 
 Spec* typeSpec(enum Type type, Spec* sub_type_spec, int lineno)
 {
-    TypeSpec* type_spec = (struct TypeSpec*)calloc(1, sizeof(TypeSpec));
+    TypeSpec* type_spec = (struct TypeSpec*)astAlloc(sizeof(TypeSpec));
     type_spec->type = type;
     type_spec->sub_type_spec = sub_type_spec;
     Spec* spec = buildSpec(TypeSpec_kind, lineno);
@@ -378,7 +408,7 @@ Spec* typeSpec(enum Type type, Spec* sub_type_spec, int lineno)
 
 Spec* prettySpec(int lineno)
 {
-    PrettySpec* pretty_spec = (struct PrettySpec*)calloc(1, sizeof(PrettySpec));
+    PrettySpec* pretty_spec = (struct PrettySpec*)astAlloc(sizeof(PrettySpec));
     pretty_spec->kind = PrettySpec_kind;
     Spec* spec = buildSpec(PrettySpec_kind, lineno);
     spec->v.pretty_spec = pretty_spec;
@@ -387,7 +417,7 @@ Spec* prettySpec(int lineno)
 
 Spec* parentDirSpec(int lineno)
 {
-    ParentDirSpec* parent_dir_spec = (struct ParentDirSpec*)calloc(1, sizeof(ParentDirSpec));
+    ParentDirSpec* parent_dir_spec = (struct ParentDirSpec*)astAlloc(sizeof(ParentDirSpec));
     parent_dir_spec->kind = ParentDirSpec_kind;
     Spec* spec = buildSpec(ParentDirSpec_kind, lineno);
     spec->v.parent_dir_spec = parent_dir_spec;
@@ -396,7 +426,7 @@ Spec* parentDirSpec(int lineno)
 
 Spec* asteriskSpec(int lineno)
 {
-    AsteriskSpec* asterisk_spec = (struct AsteriskSpec*)calloc(1, sizeof(AsteriskSpec));
+    AsteriskSpec* asterisk_spec = (struct AsteriskSpec*)astAlloc(sizeof(AsteriskSpec));
     asterisk_spec->kind = AsteriskSpec_kind;
     Spec* spec = buildSpec(AsteriskSpec_kind, lineno);
     spec->v.asterisk_spec = asterisk_spec;
@@ -405,7 +435,7 @@ Spec* asteriskSpec(int lineno)
 
 Spec* listType(int lineno)
 {
-    ListType* list_type = (struct ListType*)calloc(1, sizeof(ListType));
+    ListType* list_type = (struct ListType*)astAlloc(sizeof(ListType));
     list_type->kind = ListType_kind;
     Spec* spec = buildSpec(ListType_kind, lineno);
     spec->v.list_type = list_type;
@@ -414,7 +444,7 @@ Spec* listType(int lineno)
 
 Spec* dictType(int lineno)
 {
-    DictType* dict_type = (struct DictType*)calloc(1, sizeof(DictType));
+    DictType* dict_type = (struct DictType*)astAlloc(sizeof(DictType));
     dict_type->kind = DictType_kind;
     Spec* spec = buildSpec(DictType_kind, lineno);
     spec->v.dict_type = dict_type;
@@ -423,11 +453,11 @@ Spec* dictType(int lineno)
 
 Spec* importSpec(Expr* module_selector, Expr* ident, ExprList* names, Spec* asterisk, int lineno)
 {
-    ImportSpec* import_spec = (struct ImportSpec*)calloc(1, sizeof(ImportSpec));
+    ImportSpec* import_spec = (struct ImportSpec*)astAlloc(sizeof(ImportSpec));
     import_spec->module_selector = module_selector;
     import_spec->ident = ident;
     if (names == NULL) {
-        names = (struct ExprList*)calloc(1, sizeof(ExprList));
+        names = (struct ExprList*)astAlloc(sizeof(ExprList));
         names->expr_count = 0;
     }
     import_spec->names = names;
@@ -440,7 +470,7 @@ Spec* importSpec(Expr* module_selector, Expr* ident, ExprList* names, Spec* aste
 
 Spec* funcType(Spec* params, Spec* result, int lineno)
 {
-    FuncType* func_type = (struct FuncType*)calloc(1, sizeof(FuncType));
+    FuncType* func_type = (struct FuncType*)astAlloc(sizeof(FuncType));
     func_type->params = params;
     func_type->result = result;
     Spec* spec = buildSpec(FuncType_kind, lineno);
@@ -450,7 +480,7 @@ Spec* funcType(Spec* params, Spec* result, int lineno)
 
 Spec* fieldListSpec(SpecList* list, int lineno)
 {
-    FieldListSpec* field_list_spec = (struct FieldListSpec*)calloc(1, sizeof(FieldListSpec));
+    FieldListSpec* field_list_spec = (struct FieldListSpec*)astAlloc(sizeof(FieldListSpec));
     field_list_spec->list = list;
     Spec* spec = buildSpec(FieldListSpec_kind, lineno);
     spec->v.field_list_spec = field_list_spec;
@@ -459,7 +489,7 @@ Spec* fieldListSpec(SpecList* list, int lineno)
 
 Spec* fieldSpec(Spec* type_spec, Expr* ident, int lineno)
 {
-    FieldSpec* field_spec = (struct FieldSpec*)calloc(1, sizeof(FieldSpec));
+    FieldSpec* field_spec = (struct FieldSpec*)astAlloc(sizeof(FieldSpec));
     field_spec->type_spec = type_spec;
     field_spec->ident = ident;
     Spec* spec = buildSpec(FieldSpec_kind, lineno);
@@ -469,7 +499,7 @@ Spec* fieldSpec(Spec* type_spec, Expr* ident, int lineno)
 
 Spec* optionalFieldSpec(Spec* type_spec, Expr* ident, Expr* expr, int lineno)
 {
-    OptionalFieldSpec* optional_field_spec = (struct OptionalFieldSpec*)calloc(1, sizeof(OptionalFieldSpec));
+    OptionalFieldSpec* optional_field_spec = (struct OptionalFieldSpec*)astAlloc(sizeof(OptionalFieldSpec));
     optional_field_spec->type_spec = type_spec;
     optional_field_spec->ident = ident;
     optional_field_spec->expr = expr;
@@ -480,7 +510,7 @@ Spec* optionalFieldSpec(Spec* type_spec, Expr* ident, Expr* expr, int lineno)
 
 Spec* decisionBlock(ExprList* decisions, int lineno)
 {
-    DecisionBlock* decision_block = (struct DecisionBlock*)calloc(1, sizeof(DecisionBlock));
+    DecisionBlock* decision_block = (struct DecisionBlock*)astAlloc(sizeof(DecisionBlock));
     decision_block->decisions = decisions;
     Spec* spec = buildSpec(DecisionBlock_kind, lineno);
     spec->v.decision_block = decision_block;
@@ -492,7 +522,7 @@ Spec* decisionBlock(ExprList* decisions, int lineno)
 
 Decl* buildDecl(enum DeclKind kind, int lineno)
 {
-    Decl* decl = (struct Decl*)calloc(1, sizeof(Decl));
+    Decl* decl = (struct Decl*)astAlloc(sizeof(Decl));
     decl->ast = ast(lineno);
     decl->kind = kind;
     return decl;
@@ -500,7 +530,7 @@ Decl* buildDecl(enum DeclKind kind, int lineno)
 
 Decl* varDecl(Spec* type_spec, Expr* ident, Expr* expr, int lineno)
 {
-    VarDecl* var_decl = (struct VarDecl*)calloc(1, sizeof(VarDecl));
+    VarDecl* var_decl = (struct VarDecl*)astAlloc(sizeof(VarDecl));
     var_decl->type_spec = type_spec;
     var_decl->ident = ident;
     var_decl->expr = expr;
@@ -511,7 +541,7 @@ Decl* varDecl(Spec* type_spec, Expr* ident, Expr* expr, int lineno)
 
 Decl* timesDo(Expr* x, Expr* index, Expr* call_expr, int lineno)
 {
-    TimesDo* times_do = (struct TimesDo*)calloc(1, sizeof(TimesDo));
+    TimesDo* times_do = (struct TimesDo*)astAlloc(sizeof(TimesDo));
     times_do->x = x;
     times_do->index = index;
     times_do->call_expr = call_expr;
@@ -522,7 +552,7 @@ Decl* timesDo(Expr* x, Expr* index, Expr* call_expr, int lineno)
 
 Decl* foreachAsList(Expr* x, Expr* index, Expr* el, Expr* call_expr, int lineno)
 {
-    ForeachAsList* foreach_as_list = (struct ForeachAsList*)calloc(1, sizeof(ForeachAsList));
+    ForeachAsList* foreach_as_list = (struct ForeachAsList*)astAlloc(sizeof(ForeachAsList));
     foreach_as_list->x = x;
     foreach_as_list->index = index;
     foreach_as_list->el = el;
@@ -534,7 +564,7 @@ Decl* foreachAsList(Expr* x, Expr* index, Expr* el, Expr* call_expr, int lineno)
 
 Decl* foreachAsDict(Expr* x, Expr* index, Expr* key, Expr* value, Expr* call_expr, int lineno)
 {
-    ForeachAsDict* foreach_as_dict = (struct ForeachAsDict*)calloc(1, sizeof(ForeachAsDict));
+    ForeachAsDict* foreach_as_dict = (struct ForeachAsDict*)astAlloc(sizeof(ForeachAsDict));
     foreach_as_dict->x = x;
     foreach_as_dict->index = index;
     foreach_as_dict->key = key;
@@ -547,7 +577,7 @@ Decl* foreachAsDict(Expr* x, Expr* index, Expr* key, Expr* value, Expr* call_exp
 
 Decl* funcDecl(Spec* type, Expr* name, Stmt* body, Spec* decision, int lineno)
 {
-    FuncDecl* func_decl = (struct FuncDecl*)calloc(1, sizeof(FuncDecl));
+    FuncDecl* func_decl = (struct FuncDecl*)astAlloc(sizeof(FuncDecl));
     func_decl->type = type;
     func_decl->name = name;
     func_decl->body = body;
@@ -570,13 +600,13 @@ void addFile()
 {
     File* file = (struct File*)calloc(1, sizeof(File));
     file->imports_handled = false;
-    StmtList* stmt_list = (struct StmtList*)calloc(1, sizeof(StmtList));
+    StmtList* stmt_list = (struct StmtList*)astArenaAlloc(&file->arena, sizeof(StmtList));
     stmt_list->stmt_count = 0;
     file->stmt_list = stmt_list;
-    SpecList* imports = (struct SpecList*)calloc(1, sizeof(SpecList));
+    SpecList* imports = (struct SpecList*)astArenaAlloc(&file->arena, sizeof(SpecList));
     imports->spec_count = 0;
     file->imports = imports;
-    ExprList* aliases = (struct ExprList*)calloc(1, sizeof(ExprList));
+    ExprList* aliases = (struct ExprList*)astArenaAlloc(&file->arena, sizeof(ExprList));
     aliases->expr_count = 0;
     file->aliases = aliases;
     _ast_root->files = realloc(
@@ -586,59 +616,76 @@ void addFile()
     _ast_root->files[_ast_root->file_count - 1] = file;
 }
 
-void addExpr(ExprList* expr_list, Expr* expr)
+void freeFileAST(File* file)
+{
+    freeASTArena(&file->arena);
+    file->stmt_list = NULL;
+    file->imports = NULL;
+    file->aliases = NULL;
+    file->last_ast = NULL;
+}
+
+void freeASTFiles()
 {
-    expr_list->exprs = realloc(
-        expr_list->exprs,
-        sizeof(Expr) * ++expr_list->expr_count
+    for (unsigned long i = 0; i < _ast_root->file_count; i++)
+        freeFileAST(_ast_root->files[i]);
+}
+
+void** growASTList(void** arr, unsigned long count)
+{
+    // The capacity is the next power of two, the array is full when the count is one
+    if (count != 0 && (count & (count - 1)) != 0)
+        return arr;
+
+    unsigned long capacity = count == 0 ? 1 : count * 2;
+    return (void**)astArenaGrow(
+        &astCurrentFile()->arena,
+        arr,
+        count * sizeof(void*),
+        capacity * sizeof(void*)
     );
-    expr_list->exprs[expr_list->expr_count - 1] = expr;
+}
+
+void addExpr(ExprList* expr_list, Expr* expr)
+{
+    expr_list->exprs = (Expr**)growASTList((void**)expr_list->exprs, expr_list->expr_count);
+    expr_list->exprs[expr_list->expr_count++] = expr;
 }
 
 void addStmt(StmtList* stmt_list, Stmt* stmt)
 {
-    stmt_list->stmts = realloc(
-        stmt_list->stmts,
-        sizeof(Stmt) * ++stmt_list->stmt_count
-    );
-    stmt_list->stmts[stmt_list->stmt_count - 1] = stmt;
+    stmt_list->stmts = (Stmt**)growASTList((void**)stmt_list->stmts, stmt_list->stmt_count);
+    stmt_list->stmts[stmt_list->stmt_count++] = stmt;
 }
 
 void addSpec(SpecList* spec_list, Spec* spec)
 {
-    spec_list->specs = realloc(
-        spec_list->specs,
-        sizeof(Spec) * ++spec_list->spec_count
-    );
-    spec_list->specs[spec_list->spec_count - 1] = spec;
+    spec_list->specs = (Spec**)growASTList((void**)spec_list->specs, spec_list->spec_count);
+    spec_list->specs[spec_list->spec_count++] = spec;
 }
 
 void addStmtLine(StmtList* stmt_list, Stmt* stmt)
 {
-    stmt_list->stmts = realloc(
-        stmt_list->stmts,
-        sizeof(Stmt) * ++stmt_list->stmt_count
-    );
+    stmt_list->stmts = (Stmt**)growASTList((void**)stmt_list->stmts, stmt_list->stmt_count);
 
     for (size_t k = stmt_list->stmt_count; k > 0; k--) {
         stmt_list->stmts[k] = stmt_list->stmts[k - 1];
     }
 
     stmt_list->stmts[0] = stmt;
+    stmt_list->stmt_count++;
 }
 
 void addSpecLine(SpecList* spec_list, Spec* spec)
 {
-    spec_list->specs = realloc(
-        spec_list->specs,
-        sizeof(Spec) * ++spec_list->spec_count
-    );
+    spec_list->specs = (Spec**)growASTList((void**)spec_list->specs, spec_list->spec_count);
 
     for (size_t k = spec_list->spec_count; k > 0; k--) {
         spec_list->specs[k] = spec_list->specs[k - 1];
     }
 
     spec_list->specs[0] = spec;
+    spec_list->spec_count++;
 }
 
 FuncDeclCom* funcDeclCom(Spec* func_type, Expr* ident)
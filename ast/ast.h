@@ -30,6 +30,7 @@
 #include "../enums.h"
 #include "../utilities/helpers.h"
 #include "token.h"
+#include "ast_arena.h"
 
 typedef struct File File;
 
@@ -57,6 +58,7 @@ enum ExprKind {
     CallExpr_kind=13,
     DecisionExpr_kind=14,
     DefaultExpr_kind=15,
+    SliceExpr_kind=16,
 };
 
 typedef struct Expr {
@@ -78,6 +80,7 @@ typedef struct Expr {
         struct CallExpr* call_expr;
         struct DecisionExpr* decision_expr;
         struct DefaultExpr* default_expr;
+        struct SliceExpr* slice_expr;
     } v;
 } Expr;
 
@@ -156,6 +159,12 @@ typedef struct DefaultExpr {
     struct Stmt* outcome;
 } DefaultExpr;
 
+typedef struct SliceExpr {
+    struct Expr* x;
+    struct Expr* low;
+    struct Expr* high;
+} SliceExpr;
+
 
 // Stmt
 
@@ -423,6 +432,8 @@ typedef struct File {
     char *context;
     bool imports_handled;
     bool is_interactive;
+    ASTArena arena;
+    AST* last_ast;
 } File;
 
 typedef struct ASTRoot {
@@ -432,6 +443,23 @@ typedef struct ASTRoot {
 
 ASTRoot* _ast_root;
 
+// Parsing
+
+typedef struct ParseContext {
+    void* scanner;
+    ASTRoot* ast_root;
+    File* file;
+    enum Phase phase;
+    unsigned long long shell_indicator_block_counter;
+    bool interactive;
+    bool defer_errors;
+    char *error_message;
+    char *error_cause;
+    int error_lineno;
+} ParseContext;
+
+extern __thread ParseContext* parse_context;
+
 // Communication
 
 typedef struct FuncDeclCom {
@@ -439,6 +467,8 @@ typedef struct FuncDeclCom {
     struct Expr* ident;
 } FuncDeclCom;
 
+File* astCurrentFile();
+void* astAlloc(size_t size);
 AST* ast(int lineno);
 Expr* buildExpr(enum ExprKind kind, int lineno);
 Expr* basicLitBool(bool b, int lineno);
@@ -459,6 +489,7 @@ Expr* selectorExpr(Expr* x, Expr* sel, int lineno);
 Expr* callExpr(Expr* fun, ExprList* args, int lineno);
 Expr* decisionExpr(Expr* bool_expr, Stmt* outcome, int lineno);
 Expr* defaultExpr(Stmt* outcome, int lineno);
+Expr* sliceExpr(Expr* x, Expr* low, Expr* high, int lineno);
 Stmt* buildStmt(enum StmtKind kind, int lineno);
 Stmt* assignStmt(Expr* x, enum Token tok, Expr* y, int lineno);
 Stmt* returnStmt(Expr* x, int lineno);
@@ -492,6 +523,9 @@ Decl* foreachAsDict(Expr* x, Expr* index, Expr* key, Expr* value, Expr* call_exp
 Decl* funcDecl(Spec* type, Expr* name, Stmt* body, Spec* decision, int lineno);
 void initASTRoot();
 void addFile();
+void freeFileAST(File* file);
+void freeASTFiles();
+void** growASTList(void** arr, unsigned long count);
 void addExpr(ExprList* expr_list, Expr* expr);
 void addSpec(SpecList* spec_list, Spec* spec);
 void addStmt(StmtList* stmt_list, Stmt* stmt);
@@ -0,0 +1,100 @@
+/*
+ * Description: Abstract Syntax Tree arena module of the Chaos Programming Language's source
+ *
+ * Copyright (c) 2019-2021 Chaos Language Development Authority <info@chaos-lang.org>
+ *
+ * License: GNU General Public License v3.0
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors: M. Mert Yildiran <me@mertyildiran.com>
+ */
+
+#include "ast_arena.h"
+
+void* astArenaAlloc(ASTArena* arena, size_t size)
+{
+    size = (size + AST_ARENA_ALIGNMENT - 1) & ~(size_t)(AST_ARENA_ALIGNMENT - 1);
+
+    ASTArenaChunk* chunk = arena->chunk;
+    if (chunk == NULL || chunk->used + size > chunk->size) {
+        // Large allocations get a chunk of their own
+        size_t chunk_size = size > AST_ARENA_CHUNK_SIZE ? size : AST_ARENA_CHUNK_SIZE;
+        chunk = (ASTArenaChunk*)calloc(1, sizeof(ASTArenaChunk) + chunk_size);
+        chunk->size = chunk_size;
+        chunk->used = 0;
+        chunk->next = arena->chunk;
+        arena->chunk = chunk;
+    }
+
+    // Chunks are zeroed when they are allocated and never reused
+    void* ptr = chunk->data + chunk->used;
+    chunk->used += size;
+    arena->last = ptr;
+    return ptr;
+}
+
+void* astArenaGrow(ASTArena* arena, void* ptr, size_t size, size_t new_size)
+{
+    size = (size + AST_ARENA_ALIGNMENT - 1) & ~(size_t)(AST_ARENA_ALIGNMENT - 1);
+    new_size = (new_size + AST_ARENA_ALIGNMENT - 1) & ~(size_t)(AST_ARENA_ALIGNMENT - 1);
+
+    // The last allocation is extended in place if the chunk has room for it
+    ASTArenaChunk* chunk = arena->chunk;
+    if (ptr != NULL && ptr == arena->last && chunk->used - size + new_size <= chunk->size) {
+        chunk->used += new_size - size;
+        return ptr;
+    }
+
+    void* new_ptr = astArenaAlloc(arena, new_size);
+    if (ptr != NULL)
+        memcpy(new_ptr, ptr, size);
+    return new_ptr;
+}
+
+char* astArenaStrdup(ASTArena* arena, char *s)
+{
+    size_t len = strlen(s);
+    char *copy = (char*)astArenaAlloc(arena, len + 1);
+    memcpy(copy, s, len + 1);
+    return copy;
+}
+
+void astArenaMerge(ASTArena* arena, ASTArena* other)
+{
+    // The chunks of the other arena are moved in front, its allocations become the most recent ones
+    if (other->chunk == NULL)
+        return;
+
+    ASTArenaChunk* tail = other->chunk;
+    while (tail->next != NULL)
+        tail = tail->next;
+    tail->next = arena->chunk;
+
+    arena->chunk = other->chunk;
+    arena->last = other->last;
+    other->chunk = NULL;
+    other->last = NULL;
+}
+
+void freeASTArena(ASTArena* arena)
+{
+    ASTArenaChunk* chunk = arena->chunk;
+    while (chunk != NULL) {
+        ASTArenaChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    arena->chunk = NULL;
+    arena->last = NULL;
+}
@@ -0,0 +1,63 @@
+/*
+ * Description: Abstract Syntax Tree arena module of the Chaos Programming Language's source
+ *
+ * Copyright (c) 2019-2021 Chaos Language Development Authority <info@chaos-lang.org>
+ *
+ * License: GNU General Public License v3.0
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors: M. Mert Yildiran <me@mertyildiran.com>
+ */
+
+#ifndef KAOS_AST_ARENA_H
+#define KAOS_AST_ARENA_H
+
+#include <stdlib.h>
+#include <string.h>
+
+/*
+  The nodes of a file, their location records and the identifier and
+  string literal names are bump allocated from an arena that belongs to
+  the file. The arena is a list of chunks, an allocation that does not fit
+  into the current chunk starts a new one. Nothing is freed one by one,
+  the whole arena is released at once after the file is compiled.
+
+  0      8      16     24
+  +------+------+------+ +---------------------+
+  | next | size | used | |        data         |
+  +------+------+------+ +---------------------+
+   chunk* size_t size_t         size * byte
+*/
+#define AST_ARENA_CHUNK_SIZE 65536
+#define AST_ARENA_ALIGNMENT 8
+
+typedef struct ASTArenaChunk {
+    struct ASTArenaChunk* next;
+    size_t size;
+    size_t used;
+    char data[];
+} ASTArenaChunk;
+
+typedef struct ASTArena {
+    ASTArenaChunk* chunk;
+    void* last;
+} ASTArena;
+
+void* astArenaAlloc(ASTArena* arena, size_t size);
+void* astArenaGrow(ASTArena* arena, void* ptr, size_t size, size_t new_size);
+char* astArenaStrdup(ASTArena* arena, char *s);
+void astArenaMerge(ASTArena* arena, ASTArena* other);
+void freeASTArena(ASTArena* arena);
+
+#endif
@@ -0,0 +1,1004 @@
+/*
+ * Description: Abstract Syntax Tree cache module of the Chaos Programming Language's source
+ *
+ * Copyright (c) 2019-2021 Chaos Language Development Authority <info@chaos-lang.org>
+ *
+ * License: GNU General Public License v3.0
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors: M. Mert Yildiran <me@mertyildiran.com>
+ */
+
+#include "ast_cache.h"
+
+static bool ast_cache_initialized = false;
+static bool ast_cache_debug = false;
+
+static void writeExpr(ASTCacheWriter* writer, Expr* expr);
+static void writeStmt(ASTCacheWriter* writer, Stmt* stmt);
+static void writeSpec(ASTCacheWriter* writer, Spec* spec);
+static void writeDecl(ASTCacheWriter* writer, Decl* decl);
+static Expr* readExpr(ASTCacheReader* reader);
+static Stmt* readStmt(ASTCacheReader* reader);
+static Spec* readSpec(ASTCacheReader* reader);
+static Decl* readDecl(ASTCacheReader* reader);
+
+
+// Writer
+
+static void writeBytes(ASTCacheWriter* writer, const void* bytes, size_t size)
+{
+    if (writer->size + size > writer->capacity) {
+        size_t capacity = writer->capacity == 0 ? 4096 : writer->capacity;
+        while (writer->size + size > capacity)
+            capacity *= 2;
+        writer->arr = realloc(writer->arr, capacity);
+        writer->capacity = capacity;
+    }
+
+    memcpy(writer->arr + writer->size, bytes, size);
+    writer->size += size;
+}
+
+static void writeU8(ASTCacheWriter* writer, uint8_t value)
+{
+    writeBytes(writer, &value, sizeof(value));
+}
+
+static void writeI32(ASTCacheWriter* writer, int32_t value)
+{
+    writeBytes(writer, &value, sizeof(value));
+}
+
+static void writeU64(ASTCacheWriter* writer, uint64_t value)
+{
+    writeBytes(writer, &value, sizeof(value));
+}
+
+static void writeString(ASTCacheWriter* writer, char *s)
+{
+    uint32_t length = strlen(s);
+    writeBytes(writer, &length, sizeof(length));
+    writeBytes(writer, s, length);
+}
+
+static void writeNode(ASTCacheWriter* writer, int kind, AST* ast)
+{
+    writeU8(writer, kind);
+    writeI32(writer, ast->lineno);
+}
+
+static void writeExprList(ASTCacheWriter* writer, ExprList* expr_list)
+{
+    writeU8(writer, expr_list != NULL);
+    if (expr_list == NULL)
+        return;
+
+    writeU64(writer, expr_list->expr_count);
+    for (unsigned long i = 0; i < expr_list->expr_count; i++)
+        writeExpr(writer, expr_list->exprs[i]);
+}
+
+static void writeStmtList(ASTCacheWriter* writer, StmtList* stmt_list)
+{
+    writeU8(writer, stmt_list != NULL);
+    if (stmt_list == NULL)
+        return;
+
+    writeU64(writer, stmt_list->stmt_count);
+    for (unsigned long i = 0; i < stmt_list->stmt_count; i++)
+        writeStmt(writer, stmt_list->stmts[i]);
+}
+
+static void writeSpecList(ASTCacheWriter* writer, SpecList* spec_list)
+{
+    writeU8(writer, spec_list != NULL);
+    if (spec_list == NULL)
+        return;
+
+    writeU64(writer, spec_list->spec_count);
+    for (unsigned long i = 0; i < spec_list->spec_count; i++)
+        writeSpec(writer, spec_list->specs[i]);
+}
+
+static void writeExpr(ASTCacheWriter* writer, Expr* expr)
+{
+    if (expr == NULL) {
+        writeU8(writer, 0);
+        return;
+    }
+
+    writeNode(writer, expr->kind, expr->ast);
+
+    switch (expr->kind) {
+    case BasicLit_kind:
+        writeI32(writer, expr->v.basic_lit->value_type);
+        switch (expr->v.basic_lit->value_type) {
+        case V_BOOL:
+            writeU8(writer, expr->v.basic_lit->value.b);
+            break;
+        case V_INT:
+            writeBytes(writer, &expr->v.basic_lit->value.i, sizeof(long long));
+            break;
+        case V_FLOAT:
+            writeBytes(writer, &expr->v.basic_lit->value.f, sizeof(double));
+            break;
+        case V_STRING:
+            writeString(writer, expr->v.basic_lit->value.s);
+            break;
+        default:
+            break;
+        }
+        break;
+    case Ident_kind:
+        writeString(writer, expr->v.ident->name);
+        break;
+    case BinaryExpr_kind:
+        writeExpr(writer, expr->v.binary_expr->x);
+        writeI32(writer, expr->v.binary_expr->op);
+        writeExpr(writer, expr->v.binary_expr->y);
+        break;
+    case UnaryExpr_kind:
+        writeI32(writer, expr->v.unary_expr->op);
+        writeExpr(writer, expr->v.unary_expr->x);
+        break;
+    case ParenExpr_kind:
+        writeExpr(writer, expr->v.paren_expr->x);
+        break;
+    case IncDecExpr_kind:
+        writeI32(writer, expr->v.incdec_expr->op);
+        writeExpr(writer, expr->v.incdec_expr->x);
+        writeU8(writer, expr->v.incdec_expr->first);
+        break;
+    case ModuleSelector_kind:
+        writeSpec(writer, expr->v.module_selector->parent_dir_spec);
+        writeExpr(writer, expr->v.module_selector->x);
+        writeExpr(writer, expr->v.module_selector->sel);
+        break;
+    case AliasExpr_kind:
+        writeExpr(writer, expr->v.alias_expr->name);
+        writeExpr(writer, expr->v.alias_expr->asname);
+        break;
+    case IndexExpr_kind:
+        writeExpr(writer, expr->v.index_expr->x);
+        writeExpr(writer, expr->v.index_expr->index);
+        break;
+    case CompositeLit_kind:
+        writeSpec(writer, expr->v.composite_lit->type);
+        writeExprList(writer, expr->v.composite_lit->elts);
+        break;
+    case KeyValueExpr_kind:
+        writeExpr(writer, expr->v.key_value_expr->key);
+        writeExpr(writer, expr->v.key_value_expr->value);
+        break;
+    case SelectorExpr_kind:
+        writeExpr(writer, expr->v.selector_expr->x);
+        writeExpr(writer, expr->v.selector_expr->sel);
+        break;
+    case CallExpr_kind:
+        writeExpr(writer, expr->v.call_expr->fun);
+        writeExprList(writer, expr->v.call_expr->args);
+        break;
+    case DecisionExpr_kind:
+        writeExpr(writer, expr->v.decision_expr->bool_expr);
+        writeStmt(writer, expr->v.decision_expr->outcome);
+        break;
+    case DefaultExpr_kind:
+        writeStmt(writer, expr->v.default_expr->outcome);
+        break;
+    case SliceExpr_kind:
+        writeExpr(writer, expr->v.slice_expr->x);
+        writeExpr(writer, expr->v.slice_expr->low);
+        writeExpr(writer, expr->v.slice_expr->high);
+        break;
+    default:
+        break;
+    }
+}
+
+static void writeStmt(ASTCacheWriter* writer, Stmt* stmt)
+{
+    if (stmt == NULL) {
+        writeU8(writer, 0);
+        return;
+    }
+
+    writeNode(writer, stmt->kind, stmt->ast);
+
+    switch (stmt->kind) {
+    case AssignStmt_kind:
+        writeExpr(writer, stmt->v.assign_stmt->x);
+        writeI32(writer, stmt->v.assign_stmt->tok);
+        writeExpr(writer, stmt->v.assign_stmt->y);
+        break;
+    case PrintStmt_kind:
+        writeSpec(writer, stmt->v.print_stmt->mod);
+        writeExpr(writer, stmt->v.print_stmt->x);
+        break;
+    case EchoStmt_kind:
+        writeSpec(writer, stmt->v.echo_stmt->mod);
+        writeExpr(writer, stmt->v.echo_stmt->x);
+        break;
+    case ReturnStmt_kind:
+        writeExpr(writer, stmt->v.return_stmt->x);
+        writeU8(writer, stmt->v.return_stmt->dont_push_callx);
+        break;
+    case ExprStmt_kind:
+        writeExpr(writer, stmt->v.expr_stmt->x);
+        break;
+    case DeclStmt_kind:
+        writeDecl(writer, stmt->v.decl_stmt->decl);
+        break;
+    case DelStmt_kind:
+        writeExpr(writer, stmt->v.del_stmt->ident);
+        break;
+    case ExitStmt_kind:
+        writeExpr(writer, stmt->v.exit_stmt->x);
+        break;
+    case BlockStmt_kind:
+        writeStmtList(writer, stmt->v.block_stmt->stmt_list);
+        break;
+    default:
+        break;
+    }
+}
+
+static void writeSpec(ASTCacheWriter* writer, Spec* spec)
+{
+    if (spec == NULL) {
+        writeU8(writer, 0);
+        return;
+    }
+
+    writeNode(writer, spec->kind, spec->ast);
+
+    switch (spec->kind) {
+    case TypeSpec_kind:
+        writeI32(writer, spec->v.type_spec->type);
+        writeSpec(writer, spec->v.type_spec->sub_type_spec);
+        break;
+    case ImportSpec_kind:
+        writeExpr(writer, spec->v.import_spec->module_selector);
+        writeExpr(writer, spec->v.import_spec->ident);
+        writeExprList(writer, spec->v.import_spec->names);
+        writeSpec(writer, spec->v.import_spec->asterisk);
+        writeU8(writer, spec->v.import_spec->handled);
+        break;
+    case FuncType_kind:
+        writeSpec(writer, spec->v.func_type->params);
+        writeSpec(writer, spec->v.func_type->result);
+        break;
+    case FieldListSpec_kind:
+        writeSpecList(writer, spec->v.field_list_spec->list);
+        break;
+    case FieldSpec_kind:
+        writeSpec(writer, spec->v.field_spec->type_spec);
+        writeExpr(writer, spec->v.field_spec->ident);
+        break;
+    case OptionalFieldSpec_kind:
+        writeSpec(writer, spec->v.optional_field_spec->type_spec);
+        writeExpr(writer, spec->v.optional_field_spec->ident);
+        writeExpr(writer, spec->v.optional_field_spec->expr);
+        break;
+    case DecisionBlock_kind:
+        writeExprList(writer, spec->v.decision_block->decisions);
+        break;
+    default:
+        break;
+    }
+}
+
+static void writeDecl(ASTCacheWriter* writer, Decl* decl)
+{
+    if (decl == NULL) {
+        writeU8(writer, 0);
+        return;
+    }
+
+    writeNode(writer, decl->kind, decl->ast);
+
+    switch (decl->kind) {
+    case VarDecl_kind:
+        writeSpec(writer, decl->v.var_decl->type_spec);
+        writeExpr(writer, decl->v.var_decl->ident);
+        writeExpr(writer, decl->v.var_decl->expr);
+        break;
+    case TimesDo_kind:
+        writeExpr(writer, decl->v.times_do->x);
+        writeExpr(writer, decl->v.times_do->index);
+        writeExpr(writer, decl->v.times_do->call_expr);
+        break;
+    case ForeachAsList_kind:
+        writeExpr(writer, decl->v.foreach_as_list->x);
+        writeExpr(writer, decl->v.foreach_as_list->index);
+        writeExpr(writer, decl->v.foreach_as_list->el);
+        writeExpr(writer, decl->v.foreach_as_list->call_expr);
+        break;
+    case ForeachAsDict_kind:
+        writeExpr(writer, decl->v.foreach_as_dict->x);
+        writeExpr(writer, decl->v.foreach_as_dict->index);
+        writeExpr(writer, decl->v.foreach_as_dict->key);
+        writeExpr(writer, decl->v.foreach_as_dict->value);
+        writeExpr(writer, decl->v.foreach_as_dict->call_expr);
+        break;
+    case FuncDecl_kind:
+        writeSpec(writer, decl->v.func_decl->type);
+        writeExpr(writer, decl->v.func_decl->name);
+        writeStmt(writer, decl->v.func_decl->body);
+        writeSpec(writer, decl->v.func_decl->decision);
+        break;
+    default:
+        break;
+    }
+}
+
+static void writeHeader(ASTCacheWriter* writer, ASTCacheKey key)
+{
+    writeBytes(writer, __KAOS_AST_CACHE_MAGIC__, 4);
+    writeI32(writer, __KAOS_AST_CACHE_VERSION__);
+    writeU8(writer, __KAOS_VERSION_MAJOR__);
+    writeU8(writer, __KAOS_VERSION_MINOR__);
+    writeU8(writer, __KAOS_VERSION_PATCHLEVEL__);
+    writeU64(writer, key.hash);
+    writeU64(writer, key.length);
+}
+
+
+// Reader
+
+static void readBytes(ASTCacheReader* reader, void* bytes, size_t size)
+{
+    // A truncated or corrupted cache file fails the whole read, the module is parsed instead
+    if (reader->failed || reader->size - reader->cursor < size) {
+        reader->failed = true;
+        memset(bytes, 0, size);
+        return;
+    }
+
+    memcpy(bytes, reader->arr + reader->cursor, size);
+    reader->cursor += size;
+}
+
+static uint8_t readU8(ASTCacheReader* reader)
+{
+    uint8_t value;
+    readBytes(reader, &value, sizeof(value));
+    return value;
+}
+
+static int32_t readI32(ASTCacheReader* reader)
+{
+    int32_t value;
+    readBytes(reader, &value, sizeof(value));
+    return value;
+}
+
+static uint64_t readU64(ASTCacheReader* reader)
+{
+    uint64_t value;
+    readBytes(reader, &value, sizeof(value));
+    return value;
+}
+
+static void* readNode(ASTCacheReader* reader, size_t size)
+{
+    return astArenaAlloc(&reader->arena, size);
+}
+
+static char* readString(ASTCacheReader* reader)
+{
+    uint32_t length;
+    readBytes(reader, &length, sizeof(length));
+    if (reader->failed || reader->size - reader->cursor < length) {
+        reader->failed = true;
+        return NULL;
+    }
+
+    // The names are interned the same way the lexer does
+    char *s = intern_name(reader->arr + reader->cursor, length);
+    reader->cursor += length;
+    return s;
+}
+
+static AST* readAST(ASTCacheReader* reader)
+{
+    // Same as ast(), the consecutive nodes on the same line share one location record
+    int lineno = readI32(reader);
+    if (reader->last_ast != NULL && reader->last_ast->lineno == lineno)
+        return reader->last_ast;
+
+    AST* ast = (struct AST*)readNode(reader, sizeof(AST));
+    ast->lineno = lineno;
+    ast->file = reader->file;
+    reader->last_ast = ast;
+    return ast;
+}
+
+static void** readListArray(ASTCacheReader* reader, unsigned long count)
+{
+    // Every item takes a byte at least, a larger count can only come from a corrupted file
+    if (count > reader->size - reader->cursor) {
+        reader->failed = true;
+        return NULL;
+    }
+    if (count == 0)
+        return NULL;
+
+    // The capacity is the next power of two like growASTList() expects
+    unsigned long capacity = 1;
+    while (capacity < count)
+        capacity *= 2;
+    return (void**)readNode(reader, capacity * sizeof(void*));
+}
+
+static ExprList* readExprList(ASTCacheReader* reader)
+{
+    if (readU8(reader) == 0)
+        return NULL;
+
+    ExprList* expr_list = (struct ExprList*)readNode(reader, sizeof(ExprList));
+    unsigned long count = readU64(reader);
+    expr_list->exprs = (Expr**)readListArray(reader, count);
+    if (reader->failed)
+        return NULL;
+
+    for (unsigned long i = 0; i < count; i++)
+        expr_list->exprs[i] = readExpr(reader);
+    expr_list->expr_count = count;
+    return expr_list;
+}
+
+static StmtList* readStmtList(ASTCacheReader* reader)
+{
+    if (readU8(reader) == 0)
+        return NULL;
+
+    StmtList* stmt_list = (struct StmtList*)readNode(reader, sizeof(StmtList));
+    unsigned long count = readU64(reader);
+    stmt_list->stmts = (Stmt**)readListArray(reader, count);
+    if (reader->failed)
+        return NULL;
+
+    for (unsigned long i = 0; i < count; i++)
+        stmt_list->stmts[i] = readStmt(reader);
+    stmt_list->stmt_count = count;
+    return stmt_list;
+}
+
+static SpecList* readSpecList(ASTCacheReader* reader)
+{
+    if (readU8(reader) == 0)
+        return NULL;
+
+    SpecList* spec_list = (struct SpecList*)readNode(reader, sizeof(SpecList));
+    unsigned long count = readU64(reader);
+    spec_list->specs = (Spec**)readListArray(reader, count);
+    if (reader->failed)
+        return NULL;
+
+    for (unsigned long i = 0; i < count; i++)
+        spec_list->specs[i] = readSpec(reader);
+    spec_list->spec_count = count;
+    return spec_list;
+}
+
+static Expr* readExpr(ASTCacheReader* reader)
+{
+    enum ExprKind kind = readU8(reader);
+    if (kind == 0 || reader->failed)
+        return NULL;
+
+    Expr* expr = (struct Expr*)readNode(reader, sizeof(Expr));
+    expr->ast = readAST(reader);
+    expr->kind = kind;
+
+    switch (kind) {
+    case BasicLit_kind:
+        expr->v.basic_lit = (struct BasicLit*)readNode(reader, sizeof(BasicLit));
+        expr->v.basic_lit->value_type = readI32(reader);
+        switch (expr->v.basic_lit->value_type) {
+        case V_BOOL:
+            expr->v.basic_lit->value.b = readU8(reader);
+            break;
+        case V_INT:
+            readBytes(reader, &expr->v.basic_lit->value.i, sizeof(long long));
+            break;
+        case V_FLOAT:
+            readBytes(reader, &expr->v.basic_lit->value.f, sizeof(double));
+            break;
+        case V_STRING:
+            expr->v.basic_lit->value.s = readString(reader);
+            break;
+        default:
+            break;
+        }
+        break;
+    case Ident_kind:
+        expr->v.ident = (struct Ident*)readNode(reader, sizeof(Ident));
+        expr->v.ident->name = readString(reader);
+        break;
+    case BinaryExpr_kind:
+        expr->v.binary_expr = (struct BinaryExpr*)readNode(reader, sizeof(BinaryExpr));
+        expr->v.binary_expr->x = readExpr(reader);
+        expr->v.binary_expr->op = readI32(reader);
+        expr->v.binary_expr->y = readExpr(reader);
+        break;
+    case UnaryExpr_kind:
+        expr->v.unary_expr = (struct UnaryExpr*)readNode(reader, sizeof(UnaryExpr));
+        expr->v.unary_expr->op = readI32(reader);
+        expr->v.unary_expr->x = readExpr(reader);
+        break;
+    case ParenExpr_kind:
+        expr->v.paren_expr = (struct ParenExpr*)readNode(reader, sizeof(ParenExpr));
+        expr->v.paren_expr->x = readExpr(reader);
+        break;
+    case IncDecExpr_kind:
+        expr->v.incdec_expr = (struct IncDecExpr*)readNode(reader, sizeof(IncDecExpr));
+        expr->v.incdec_expr->op = readI32(reader);
+        expr->v.incdec_expr->x = readExpr(reader);
+        expr->v.incdec_expr->first = readU8(reader);
+        break;
+    case ModuleSelector_kind:
+        expr->v.module_selector = (struct ModuleSelector*)readNode(reader, sizeof(ModuleSelector));
+        expr->v.module_selector->parent_dir_spec = readSpec(reader);
+        expr->v.module_selector->x = readExpr(reader);
+        expr->v.module_selector->sel = readExpr(reader);
+        break;
+    case AliasExpr_kind:
+        expr->v.alias_expr = (struct AliasExpr*)readNode(reader, sizeof(AliasExpr));
+        expr->v.alias_expr->name = readExpr(reader);
+        expr->v.alias_expr->asname = readExpr(reader);
+        break;
+    case IndexExpr_kind:
+        expr->v.index_expr = (struct IndexExpr*)readNode(reader, sizeof(IndexExpr));
+        expr->v.index_expr->x = readExpr(reader);
+        expr->v.index_expr->index = readExpr(reader);
+        break;
+    case CompositeLit_kind:
+        expr->v.composite_lit = (struct CompositeLit*)readNode(reader, sizeof(CompositeLit));
+        expr->v.composite_lit->type = readSpec(reader);
+        expr->v.composite_lit->elts = readExprList(reader);
+        break;
+    case KeyValueExpr_kind:
+        expr->v.key_value_expr = (struct KeyValueExpr*)readNode(reader, sizeof(KeyValueExpr));
+        expr->v.key_value_expr->key = readExpr(reader);
+        expr->v.key_value_expr->value = readExpr(reader);
+        break;
+    case SelectorExpr_kind:
+        expr->v.selector_expr = (struct SelectorExpr*)readNode(reader, sizeof(SelectorExpr));
+        expr->v.selector_expr->x = readExpr(reader);
+        expr->v.selector_expr->sel = readExpr(reader);
+        break;
+    case CallExpr_kind:
+        expr->v.call_expr = (struct CallExpr*)readNode(reader, sizeof(CallExpr));
+        expr->v.call_expr->fun = readExpr(reader);
+        expr->v.call_expr->args = readExprList(reader);
+        break;
+    case DecisionExpr_kind:
+        expr->v.decision_expr = (struct DecisionExpr*)readNode(reader, sizeof(DecisionExpr));
+        expr->v.decision_expr->bool_expr = readExpr(reader);
+        expr->v.decision_expr->outcome = readStmt(reader);
+        break;
+    case DefaultExpr_kind:
+        expr->v.default_expr = (struct DefaultExpr*)readNode(reader, sizeof(DefaultExpr));
+        expr->v.default_expr->outcome = readStmt(reader);
+        break;
+    case SliceExpr_kind:
+        expr->v.slice_expr = (struct SliceExpr*)readNode(reader, sizeof(SliceExpr));
+        expr->v.slice_expr->x = readExpr(reader);
+        expr->v.slice_expr->low = readExpr(reader);
+        expr->v.slice_expr->high = readExpr(reader);
+        break;
+    default:
+        reader->failed = true;
+        return NULL;
+    }
+
+    return expr;
+}
+
+static Stmt* readStmt(ASTCacheReader* reader)
+{
+    enum StmtKind kind = readU8(reader);
+    if (kind == 0 || reader->failed)
+        return NULL;
+
+    Stmt* stmt = (struct Stmt*)readNode(reader, sizeof(Stmt));
+    stmt->ast = readAST(reader);
+    stmt->kind = kind;
+
+    switch (kind) {
+    case AssignStmt_kind:
+        stmt->v.assign_stmt = (struct AssignStmt*)readNode(reader, sizeof(AssignStmt));
+        stmt->v.assign_stmt->x = readExpr(reader);
+        stmt->v.assign_stmt->tok = readI32(reader);
+        stmt->v.assign_stmt->y = readExpr(reader);
+        break;
+    case PrintStmt_kind:
+        stmt->v.print_stmt = (struct PrintStmt*)readNode(reader, sizeof(PrintStmt));
+        stmt->v.print_stmt->mod = readSpec(reader);
+        stmt->v.print_stmt->x = readExpr(reader);
+        break;
+    case EchoStmt_kind:
+        stmt->v.echo_stmt = (struct EchoStmt*)readNode(reader, sizeof(EchoStmt));
+        stmt->v.echo_stmt->mod = readSpec(reader);
+        stmt->v.echo_stmt->x = readExpr(reader);
+        break;
+    case ReturnStmt_kind:
+        stmt->v.return_stmt = (struct ReturnStmt*)readNode(reader, sizeof(ReturnStmt));
+        stmt->v.return_stmt->x = readExpr(reader);
+        stmt->v.return_stmt->dont_push_callx = readU8(reader);
+        break;
+    case ExprStmt_kind:
+        stmt->v.expr_stmt = (struct ExprStmt*)readNode(reader, sizeof(ExprStmt));
+        stmt->v.expr_stmt->x = readExpr(reader);
+        break;
+    case DeclStmt_kind:
+        stmt->v.decl_stmt = (struct DeclStmt*)readNode(reader, sizeof(DeclStmt));
+        stmt->v.decl_stmt->decl = readDecl(reader);
+        break;
+    case DelStmt_kind:
+        stmt->v.del_stmt = (struct DelStmt*)readNode(reader, sizeof(DelStmt));
+        stmt->v.del_stmt->ident = readExpr(reader);
+        break;
+    case ExitStmt_kind:
+        stmt->v.exit_stmt = (struct ExitStmt*)readNode(reader, sizeof(ExitStmt));
+        stmt->v.exit_stmt->x = readExpr(reader);
+        break;
+    case SymbolTableStmt_kind:
+        break;
+    case FunctionTableStmt_kind:
+        stmt->v.function_table_stmt = (struct FunctionTableStmt*)readNode(reader, sizeof(FunctionTableStmt));
+        stmt->v.function_table_stmt->kind = FunctionTableStmt_kind;
+        break;
+    case BlockStmt_kind:
+        stmt->v.block_stmt = (struct BlockStmt*)readNode(reader, sizeof(BlockStmt));
+        stmt->v.block_stmt->stmt_list = readStmtList(reader);
+        break;
+    case BreakStmt_kind:
+        stmt->v.break_stmt = (struct BreakStmt*)readNode(reader, sizeof(BreakStmt));
+        stmt->v.break_stmt->kind = BreakStmt_kind;
+        break;
+    default:
+        reader->failed = true;
+        return NULL;
+    }
+
+    return stmt;
+}
+
+static Spec* readSpec(ASTCacheReader* reader)
+{
+    enum SpecKind kind = readU8(reader);
+    if (kind == 0 || reader->failed)
+        return NULL;
+
+    Spec* spec = (struct Spec*)readNode(reader, sizeof(Spec));
+    spec->ast = readAST(reader);
+    spec->kind = kind;
+
+    switch (kind) {
+    case TypeSpec_kind:
+        spec->v.type_spec = (struct TypeSpec*)readNode(reader, sizeof(TypeSpec));
+        spec->v.type_spec->type = readI32(reader);
+        spec->v.type_spec->sub_type_spec = readSpec(reader);
+        break;
+    case PrettySpec_kind:
+        spec->v.pretty_spec = (struct PrettySpec*)readNode(reader, sizeof(PrettySpec));
+        spec->v.pretty_spec->kind = PrettySpec_kind;
+        break;
+    case ParentDirSpec_kind:
+        spec->v.parent_dir_spec = (struct ParentDirSpec*)readNode(reader, sizeof(ParentDirSpec));
+        spec->v.parent_dir_spec->kind = ParentDirSpec_kind;
+        break;
+    case AsteriskSpec_kind:
+        spec->v.asterisk_spec = (struct AsteriskSpec*)readNode(reader, sizeof(AsteriskSpec));
+        spec->v.asterisk_spec->kind = AsteriskSpec_kind;
+        break;
+    case ImportSpec_kind:
+        spec->v.import_spec = (struct ImportSpec*)readNode(reader, sizeof(ImportSpec));
+        spec->v.import_spec->module_selector = readExpr(reader);
+        spec->v.import_spec->ident = readExpr(reader);
+        spec->v.import_spec->names = readExprList(reader);
+        spec->v.import_spec->asterisk = readSpec(reader);
+        spec->v.import_spec->handled = readU8(reader);
+        break;
+    case ListType_kind:
+        spec->v.list_type = (struct ListType*)readNode(reader, sizeof(ListType));
+        spec->v.list_type->kind = ListType_kind;
+        break;
+    case DictType_kind:
+        spec->v.dict_type = (struct DictType*)readNode(reader, sizeof(DictType));
+        spec->v.dict_type->kind = DictType_kind;
+        break;
+    case FuncType_kind:
+        spec->v.func_type = (struct FuncType*)readNode(reader, sizeof(FuncType));
+        spec->v.func_type->params = readSpec(reader);
+        spec->v.func_type->result = readSpec(reader);
+        break;
+    case FieldListSpec_kind:
+        spec->v.field_list_spec = (struct FieldListSpec*)readNode(reader, sizeof(FieldListSpec));
+        spec->v.field_list_spec->list = readSpecList(reader);
+        break;
+    case FieldSpec_kind:
+        spec->v.field_spec = (struct FieldSpec*)readNode(reader, sizeof(FieldSpec));
+        spec->v.field_spec->type_spec = readSpec(reader);
+        spec->v.field_spec->ident = readExpr(reader);
+        break;
+    case OptionalFieldSpec_kind:
+        spec->v.optional_field_spec = (struct OptionalFieldSpec*)readNode(reader, sizeof(OptionalFieldSpec));
+        spec->v.optional_field_spec->type_spec = readSpec(reader);
+        spec->v.optional_field_spec->ident = readExpr(reader);
+        spec->v.optional_field_spec->expr = readExpr(reader);
+        break;
+    case DecisionBlock_kind:
+        spec->v.decision_block = (struct DecisionBlock*)readNode(reader, sizeof(DecisionBlock));
+        spec->v.decision_block->decisions = readExprList(reader);
+        break;
+    default:
+        reader->failed = true;
+        return NULL;
+    }
+
+    return spec;
+}
+
+static Decl* readDecl(ASTCacheReader* reader)
+{
+    enum DeclKind kind = readU8(reader);
+    if (kind == 0 || reader->failed)
+        return NULL;
+
+    Decl* decl = (struct Decl*)readNode(reader, sizeof(Decl));
+    decl->ast = readAST(reader);
+    decl->kind = kind;
+
+    switch (kind) {
+    case VarDecl_kind:
+        decl->v.var_decl = (struct VarDecl*)readNode(reader, sizeof(VarDecl));
+        decl->v.var_decl->type_spec = readSpec(reader);
+        decl->v.var_decl->ident = readExpr(reader);
+        decl->v.var_decl->expr = readExpr(reader);
+        break;
+    case TimesDo_kind:
+        decl->v.times_do = (struct TimesDo*)readNode(reader, sizeof(TimesDo));
+        decl->v.times_do->x = readExpr(reader);
+        decl->v.times_do->index = readExpr(reader);
+        decl->v.times_do->call_expr = readExpr(reader);
+        break;
+    case ForeachAsList_kind:
+        decl->v.foreach_as_list = (struct ForeachAsList*)readNode(reader, sizeof(ForeachAsList));
+        decl->v.foreach_as_list->x = readExpr(reader);
+        decl->v.foreach_as_list->index = readExpr(reader);
+        decl->v.foreach_as_list->el = readExpr(reader);
+        decl->v.foreach_as_list->call_expr = readExpr(reader);
+        break;
+    case ForeachAsDict_kind:
+        decl->v.foreach_as_dict = (struct ForeachAsDict*)readNode(reader, sizeof(ForeachAsDict));
+        decl->v.foreach_as_dict->x = readExpr(reader);
+        decl->v.foreach_as_dict->index = readExpr(reader);
+        decl->v.foreach_as_dict->key = readExpr(reader);
+        decl->v.foreach_as_dict->value = readExpr(reader);
+        decl->v.foreach_as_dict->call_expr = readExpr(reader);
+        break;
+    case FuncDecl_kind:
+        decl->v.func_decl = (struct FuncDecl*)readNode(reader, sizeof(FuncDecl));
+        decl->v.func_decl->type = readSpec(reader);
+        decl->v.func_decl->name = readExpr(reader);
+        decl->v.func_decl->body = readStmt(reader);
+        decl->v.func_decl->decision = readSpec(reader);
+        break;
+    default:
+        reader->failed = true;
+        return NULL;
+    }
+
+    return decl;
+}
+
+static bool readHeader(ASTCacheReader* reader, ASTCacheKey key)
+{
+    char magic[4];
+    readBytes(reader, magic, sizeof(magic));
+    bool valid = memcmp(magic, __KAOS_AST_CACHE_MAGIC__, sizeof(magic)) == 0;
+    valid = readI32(reader) == __KAOS_AST_CACHE_VERSION__ && valid;
+    valid = readU8(reader) == __KAOS_VERSION_MAJOR__ && valid;
+    valid = readU8(reader) == __KAOS_VERSION_MINOR__ && valid;
+    valid = readU8(reader) == __KAOS_VERSION_PATCHLEVEL__ && valid;
+    valid = readU64(reader) == key.hash && valid;
+    valid = readU64(reader) == key.length && valid;
+    return valid && !reader->failed;
+}
+
+
+// Cache
+
+static bool makeDirectory(char *path)
+{
+#if defined(_WIN32) || defined(_WIN64) || defined(__CYGWIN__)
+    return _mkdir(path) == 0 || errno == EEXIST;
+#else
+    return mkdir(path, 0755) == 0 || errno == EEXIST;
+#endif
+}
+
+void initASTCache()
+{
+    if (ast_cache_initialized)
+        return;
+    ast_cache_initialized = true;
+
+    char *debug = getenv(__KAOS_AST_CACHE_DEBUG_ENV__);
+    ast_cache_debug = debug != NULL && debug[0] != '\0';
+
+    char *disable = getenv(__KAOS_AST_CACHE_DISABLE_ENV__);
+    if (disable != NULL && disable[0] != '\0')
+        return;
+
+    // The cache lives in the user's cache directory, it's disabled if there is none
+    char *dir = NULL;
+#if defined(_WIN32) || defined(_WIN64) || defined(__CYGWIN__)
+    char *local_app_data = getenv("LOCALAPPDATA");
+    if (local_app_data != NULL)
+        dir = strcat_ext(NULL, local_app_data);
+#else
+    char *xdg_cache_home = getenv("XDG_CACHE_HOME");
+    char *home = getenv("HOME");
+    if (xdg_cache_home != NULL && xdg_cache_home[0] != '\0') {
+        dir = strcat_ext(NULL, xdg_cache_home);
+    } else if (home != NULL) {
+        dir = strcat_ext(NULL, home);
+        dir = strcat_ext(dir, __KAOS_PATH_SEPARATOR__ ".cache");
+    }
+#endif
+    if (dir == NULL)
+        return;
+
+    bool created = makeDirectory(dir);
+    dir = strcat_ext(dir, __KAOS_PATH_SEPARATOR__ __KAOS_CACHE_DIR__);
+    created = created && makeDirectory(dir);
+    dir = strcat_ext(dir, __KAOS_PATH_SEPARATOR__ __KAOS_AST_CACHE_DIR__);
+    created = created && makeDirectory(dir);
+    if (!created) {
+        free(dir);
+        return;
+    }
+
+    ast_cache_dir = dir;
+}
+
+ASTCacheKey astCacheKey(source_buffer* source)
+{
+    ASTCacheKey key;
+    key.hash = intern_hash_bytes(source->arr, source->length);
+    key.length = source->length;
+    return key;
+}
+
+static char* astCachePath(ASTCacheKey key)
+{
+    size_t size = strlen(ast_cache_dir) + 32;
+    char *path = malloc(size);
+    snprintf(
+        path,
+        size,
+        "%s" __KAOS_PATH_SEPARATOR__ "%016llx." __KAOS_AST_CACHE_EXTENSION__,
+        ast_cache_dir,
+        key.hash
+    );
+    return path;
+}
+
+static void astCacheTrace(const char *event, File* file)
+{
+    // A single call, the lines of the parallel workers do not interleave
+    if (ast_cache_debug)
+        fprintf(stderr, "AST cache %s: %s\n", event, file->module_path);
+}
+
+bool loadASTCache(File* file, ASTCacheKey key)
+{
+    if (ast_cache_dir == NULL)
+        return false;
+
+    char *path = astCachePath(key);
+    FILE* fp = fopen(path, "rb");
+    free(path);
+    if (fp == NULL) {
+        astCacheTrace("miss", file);
+        return false;
+    }
+
+    ASTCacheReader reader;
+    reader.size = 0;
+    if (fseek(fp, 0, SEEK_END) == 0) {
+        long size = ftell(fp);
+        if (size > 0)
+            reader.size = size;
+    }
+    rewind(fp);
+    reader.arr = malloc(reader.size + 1);
+    reader.cursor = 0;
+    reader.failed = fread(reader.arr, 1, reader.size, fp) != reader.size;
+    reader.arena.chunk = NULL;
+    reader.arena.last = NULL;
+    reader.file = file;
+    reader.last_ast = NULL;
+    fclose(fp);
+
+    SpecList* imports = NULL;
+    StmtList* stmt_list = NULL;
+    if (readHeader(&reader, key)) {
+        imports = readSpecList(&reader);
+        stmt_list = readStmtList(&reader);
+    }
+
+    bool loaded = !reader.failed && reader.cursor == reader.size && imports != NULL && stmt_list != NULL;
+    free(reader.arr);
+    if (!loaded) {
+        astCacheTrace("reject", file);
+        freeASTArena(&reader.arena);
+        return false;
+    }
+
+    // The rebuilt nodes join the file's arena, they are released along with the rest of the file
+    astArenaMerge(&file->arena, &reader.arena);
+    file->imports = imports;
+    file->stmt_list = stmt_list;
+    file->last_ast = reader.last_ast;
+    astCacheTrace("hit", file);
+    return true;
+}
+
+void saveASTCache(File* file, ASTCacheKey key)
+{
+    if (ast_cache_dir == NULL)
+        return;
+
+    ASTCacheWriter writer;
+    writer.arr = NULL;
+    writer.size = 0;
+    writer.capacity = 0;
+    writeHeader(&writer, key);
+    writeSpecList(&writer, file->imports);
+    writeStmtList(&writer, file->stmt_list);
+
+    // Written under a name of its own first, so the other processes never load a partial file
+    char *path = astCachePath(key);
+    size_t size = strlen(path) + 64;
+    char *temp_path = malloc(size);
+    snprintf(temp_path, size, "%s.%ld.%lx.tmp", path, (long)getpid(), (unsigned long)(uintptr_t)file);
+
+    FILE* fp = fopen(temp_path, "wb");
+    if (fp != NULL) {
+        bool written = fwrite(writer.arr, 1, writer.size, fp) == writer.size;
+        written = fclose(fp) == 0 && written;
+        if (!written || rename(temp_path, path) != 0)
+            remove(temp_path);
+        else
+            astCacheTrace("write", file);
+    }
+
+    free(temp_path);
+    free(path);
+    free(writer.arr);
+}
+
+void freeASTCache()
+{
+    free(ast_cache_dir);
+    ast_cache_dir = NULL;
+    ast_cache_initialized = false;
+    ast_cache_debug = false;
+}
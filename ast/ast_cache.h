@@ -0,0 +1,97 @@
+/*
+ * Description: Abstract Syntax Tree cache module of the Chaos Programming Language's source
+ *
+ * Copyright (c) 2019-2021 Chaos Language Development Authority <info@chaos-lang.org>
+ *
+ * License: GNU General Public License v3.0
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors: M. Mert Yildiran <me@mertyildiran.com>
+ */
+
+#ifndef KAOS_AST_CACHE_H
+#define KAOS_AST_CACHE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <errno.h>
+
+#if defined(_WIN32) || defined(_WIN64) || defined(__CYGWIN__)
+#   include <process.h>
+#endif
+
+#include "ast.h"
+#include "../utilities/language.h"
+#include "../utilities/platform.h"
+#include "../vm/intern.h"
+
+/*
+  The AST of an imported module is written to the cache directory after it
+  is parsed, into a file that is named after the hash of the module's
+  source. A module whose source did not change is rebuilt from there, flex
+  and bison never see it again. The nodes follow the header in pre-order:
+  a kind byte (zero for NULL), the line number and the fields in their
+  declaration order. Lists are a presence byte, a count and the items,
+  strings are a length and the bytes. Integers are in the native byte
+  order, the cache is not meant to be shared between machines.
+
+  Setting the CHAOS_NO_AST_CACHE environment variable turns the cache off,
+  the modules are then always parsed and nothing is written. Setting
+  CHAOS_AST_CACHE_DEBUG reports every lookup and write on stderr as
+  "AST cache <hit|miss|reject|write>: <module path>".
+
+  0      4         8     9     10    11     19          27
+  +------+---------+-----+-----+-----+------+-----------+ +-------------+
+  | KAST | version | maj | min | pat | hash |  length   | |    nodes    |
+  +------+---------+-----+-----+-----+------+-----------+ +-------------+
+   char[4]   u32     u8    u8    u8    u64      u64
+*/
+#define __KAOS_AST_CACHE_MAGIC__ "KAST"
+#define __KAOS_AST_CACHE_VERSION__ 2
+#define __KAOS_AST_CACHE_EXTENSION__ "kast"
+#define __KAOS_CACHE_DIR__ "chaos"
+#define __KAOS_AST_CACHE_DIR__ "ast"
+#define __KAOS_AST_CACHE_DISABLE_ENV__ "CHAOS_NO_AST_CACHE"
+#define __KAOS_AST_CACHE_DEBUG_ENV__ "CHAOS_AST_CACHE_DEBUG"
+
+typedef struct ASTCacheKey {
+    unsigned long long hash;
+    unsigned long long length;
+} ASTCacheKey;
+
+typedef struct ASTCacheWriter {
+    char *arr;
+    size_t size;
+    size_t capacity;
+} ASTCacheWriter;
+
+typedef struct ASTCacheReader {
+    char *arr;
+    size_t size;
+    size_t cursor;
+    bool failed;
+    ASTArena arena;
+    File* file;
+    AST* last_ast;
+} ASTCacheReader;
+
+char *ast_cache_dir;
+
+void initASTCache();
+ASTCacheKey astCacheKey(source_buffer* source);
+bool loadASTCache(File* file, ASTCacheKey key);
+void saveASTCache(File* file, ASTCacheKey key);
+void freeASTCache();
+
+#endif
@@ -456,7 +456,10 @@ void printASTExpr(Expr* expr, bool is_list, char *end)
             indent,
             __KAOS_INDENT_CHAR__
         );
-        printASTExpr(expr->v.index_expr->index, false, "\n");
+        if (expr->v.index_expr->index == NULL)
+            printf("null\n");
+        else
+            printASTExpr(expr->v.index_expr->index, false, "\n");
         break;
     case CompositeLit_kind:
         printf(
@@ -548,6 +551,34 @@ void printASTExpr(Expr* expr, bool is_list, char *end)
         );
         printASTStmt(expr->v.default_expr->outcome, false, "\n");
         break;
+    case SliceExpr_kind:
+        printf(
+            "%*c\"_type\": \"SliceExpr\",\n%*c\"x\": ",
+            indent,
+            __KAOS_INDENT_CHAR__,
+            indent,
+            __KAOS_INDENT_CHAR__
+        );
+        printASTExpr(expr->v.slice_expr->x, false, ",\n");
+        printf(
+            "%*c\"low\": ",
+            indent,
+            __KAOS_INDENT_CHAR__
+        );
+        if (expr->v.slice_expr->low == NULL)
+            printf("null,\n");
+        else
+            printASTExpr(expr->v.slice_expr->low, false, ",\n");
+        printf(
+            "%*c\"high\": ",
+            indent,
+            __KAOS_INDENT_CHAR__
+        );
+        if (expr->v.slice_expr->high == NULL)
+            printf("null\n");
+        else
+            printASTExpr(expr->v.slice_expr->high, false, "\n");
+        break;
     default:
         break;
     }
@@ -37,6 +37,13 @@ i64 op_counter = 0;
 int stack_counter = 0;
 i64 register_offset = 0;
 
+BuiltinFunction builtin_functions[BUILTIN_FUNCTIONS_LENGTH] = {
+    {"join", DYN_STR_JOIN, 2, {V_LIST, V_STRING}, {"list", "separator"}, V_STRING},
+    {"split", DYN_STR_SPLIT, 2, {V_STRING, V_STRING}, {"text", "separator"}, V_LIST},
+    {"replace", DYN_STR_REPLACE, 3, {V_STRING, V_STRING, V_STRING}, {"text", "old", "new"}, V_STRING},
+    {"repeat", DYN_STR_REPEAT, 2, {V_STRING, V_INT}, {"text", "count"}, V_STRING}
+};
+
 KaosIR* compile(ASTRoot* ast_root)
 {
     KaosIR* program = initProgram();
@@ -112,8 +119,11 @@ void fillCallJumps(KaosIR* program)
 void compileImports(ASTRoot* ast_root, KaosIR* program)
 {
     while (true) {
+        // The imported files are parsed together at the end of each pass, so only the files
+        // that are parsed by now are looked into
         bool all_imports_handled = true;
-        for (unsigned long i = 0; i < ast_root->file_count; i++) {
+        unsigned long file_count = ast_root->file_count;
+        for (unsigned long i = 0; i < file_count; i++) {
             File* file = ast_root->files[i];
             import_parent_context = file;
             if (file->imports_handled)
@@ -128,6 +138,8 @@ void compileImports(ASTRoot* ast_root, KaosIR* program)
             file->imports_handled = true;
         }
 
+        parseQueuedModules();
+
         if (all_imports_handled)
             break;
     }
@@ -168,10 +180,34 @@ void compileStmt(KaosIR* program, Stmt* stmt)
         compileDecl(program, stmt->v.decl_stmt->decl);
         break;
     case AssignStmt_kind: {
+        // `s = s + y` appends y to the string s in place
+        if (is_string_append(stmt->v.assign_stmt)) {
+            Symbol* symbol = getSymbol(stmt->v.assign_stmt->x->v.ident->name);
+            compileExpr(program, stmt->v.assign_stmt->y->v.binary_expr->y);
+            push_inst_r_i(program, REF_ALLOCAI, R2, symbol->addr);
+            push_inst_(program, DYN_STR_APPEND);
+            break;
+        }
+
+        // `a[] = y` appends y to the list a
+        if (stmt->v.assign_stmt->x->kind == IndexExpr_kind && stmt->v.assign_stmt->x->v.index_expr->index == NULL) {
+            Symbol* symbol = getSymbol(stmt->v.assign_stmt->x->v.index_expr->x->v.ident->name);
+            if (symbol->type != K_LIST)
+                throw_error(E_NOT_A_LIST, symbol->name);
+
+            compileExpr(program, stmt->v.assign_stmt->x->v.index_expr->x);
+            push_inst_r_r(program, MOVR, R12, R1);
+            compileExpr(program, stmt->v.assign_stmt->y);
+            push_inst_(program, DYN_LIST_APPEND);
+            break;
+        }
+
         compileExpr(program, stmt->v.assign_stmt->x);
         push_inst_r_r(program, MOVR, R12, R5);
         push_inst_r_r(program, MOVR, R13, R11);
         push_inst_r_r(program, MOVR, R9, R2);
+        if (stmt->v.assign_stmt->x->kind == IndexExpr_kind)
+            push_inst_r_r(program, MOVR, R8, R6);
         // shift_registers(program);
         compileExpr(program, stmt->v.assign_stmt->y);
         switch (stmt->v.assign_stmt->x->kind) {
@@ -308,7 +344,10 @@ void compileStmt(KaosIR* program, Stmt* stmt)
                     if (stmt->v.assign_stmt->y->v.basic_lit->value_type != V_STRING) {
                         throw_error(E_ILLEGAL_CHARACTER_ASSIGNMENT_FOR_STRING, symbol->name);
                     } else {
-                        if (strlen(stmt->v.assign_stmt->y->v.basic_lit->value.s) != 1)
+                        char* s = escape_the_sequences_in_string_literal(stmt->v.assign_stmt->y->v.basic_lit->value.s);
+                        size_t len = strlen(s);
+                        free(s);
+                        if (len != 1)
                             throw_error(E_NOT_A_CHARACTER, symbol->name);
                     }
                     break;
@@ -349,9 +388,7 @@ void compileStmt(KaosIR* program, Stmt* stmt)
 
             switch (symbol->type) {
             case K_STRING:
-                push_inst_r_i(program, MOVI, R2, sizeof(size_t));
-                push_inst_r_r_r_i(program, LDXR, R3, R1, R2, sizeof(char));
-                push_inst_r_r_r_i(program, STXR, R5, R4, R3, sizeof(char));
+                push_inst_(program, DYN_STR_INDEX_UPDATE);
                 break;
             case K_LIST:
                 push_inst_(program, DYN_LIST_INDEX_UPDATE);
@@ -377,10 +414,16 @@ void compileStmt(KaosIR* program, Stmt* stmt)
             break;
         }
         case IndexExpr_kind: {
-            compileExpr(program, stmt->v.del_stmt->ident->v.index_expr->x);
-            push_inst_r_r(program, MOVR, R11, R1);
-            compileExpr(program, stmt->v.del_stmt->ident->v.index_expr->index);
             Symbol* symbol = getSymbol(stmt->v.del_stmt->ident->v.index_expr->x->v.ident->name);
+            // Inline strings can only be modified through their cell
+            if (symbol->type == K_STRING) {
+                peek_string(program, symbol);
+                push_inst_r_r(program, MOVR, R11, R2);
+            } else {
+                compileExpr(program, stmt->v.del_stmt->ident->v.index_expr->x);
+                push_inst_r_r(program, MOVR, R11, R1);
+            }
+            compileExpr(program, stmt->v.del_stmt->ident->v.index_expr->index);
 
             if (symbol->type != K_LIST && symbol->type != K_DICT && symbol->type != K_STRING)
                 throw_error(E_UNRECOGNIZED_COMPLEX_DATA_TYPE, getTypeName(symbol->type), symbol->name);
@@ -458,31 +501,15 @@ unsigned short compileExpr(KaosIR* program, Expr* expr)
             break;
         case V_STRING: {
             /*
-              0      8                     size+8       size+9
-              +------+ +-----------------+ +-----------------+
-              | size | |     string      | | null-terminator |
-              +------+ +-----------------+ +-----------------+
-               size_t     size * char             char
+              String literals are interned at compile time, short ones are
+              packed inline into the value word (see vm/intern.h). Escape
+              sequences are resolved here once, so runtime strings already
+              hold their final characters.
             */
-            size_t len = strlen(expr->v.basic_lit->value.s);
-            i64 addr = stack_counter++;
-            push_inst_i_i(program, ALLOCAI, addr, (len + 1) * sizeof(char) + sizeof(size_t));
-            push_inst_r_i(program, REF_ALLOCAI, R1, addr);
-
-            push_inst_r_i(program, MOVI, R3, len);
-            push_inst_r_r_i(program, STR, R1, R3, sizeof(size_t));
-
-            for (size_t i = 0; i < len; i++) {
-                push_inst_r_i(program, MOVI, R2, i * sizeof(char) + sizeof(size_t));
-                push_inst_r_i(program, MOVI, R3, expr->v.basic_lit->value.s[i]);
-                push_inst_r_r_r_i(program, STXR, R1, R2, R3, sizeof(char));
-            }
-
-            push_inst_r_i(program, MOVI, R2, len * sizeof(char) + sizeof(size_t));
-            push_inst_r_i(program, MOVI, R3, '\0');
-            push_inst_r_r_r_i(program, STXR, R1, R2, R3, sizeof(char));
-
+            char* s = escape_the_sequences_in_string_literal(expr->v.basic_lit->value.s);
+            push_inst_r_i(program, MOVI, R1, intern_string(s, strlen(s)));
             push_inst_r_i(program, MOVI, R0, V_STRING);
+            free(s);
             break;
         }
         default:
@@ -521,19 +548,43 @@ unsigned short compileExpr(KaosIR* program, Expr* expr)
         break;
     }
     case BinaryExpr_kind: {
+        // Chained string additions are concatenated with a single allocation
+        size_t operand_count = count_string_concat_operands(expr);
+        if (operand_count > 2) {
+            i64 addr = stack_counter++;
+            push_inst_i_i(program, ALLOCAI, addr, operand_count * sizeof(i64));
+            size_t i = 0;
+            compile_string_concat_operands(program, expr, addr, &i);
+            push_inst_r_i(program, REF_ALLOCAI, R1, addr);
+            push_inst_r_i(program, DYN_STR_CONCAT, R1, operand_count);
+            push_inst_r_i(program, MOVI, R0, V_STRING);
+            return V_STRING + 1;
+        }
+
         enum ValueType type = compileExpr(program, expr->v.binary_expr->y);
         shift_registers(program);
         i64 addr = stack_counter++;
-        if (expr->v.binary_expr->x->kind == ParenExpr_kind || expr->v.binary_expr->x->kind == BinaryExpr_kind) {
-            push_inst_i_i(program, ALLOCAI, addr, sizeof(long long));
+        // Compiling these clobbers the right-hand operand, its type, value and float value are kept on the stack
+        enum ExprKind x_kind = expr->v.binary_expr->x->kind;
+        bool keep_y = x_kind == ParenExpr_kind || x_kind == BinaryExpr_kind || x_kind == SliceExpr_kind || x_kind == IndexExpr_kind;
+        if (keep_y) {
+            push_inst_i_i(program, ALLOCAI, addr, 3 * sizeof(long long));
             push_inst_r_i(program, REF_ALLOCAI, R2, addr);
-            push_inst_r_r_i(program, STR, R2, R1, sizeof(long long));
+            push_inst_r_r_i(program, STR, R2, R4, sizeof(long long));
+            push_inst_r_i(program, MOVI, R3, sizeof(long long));
+            push_inst_r_r_r_i(program, STXR, R2, R3, R5, sizeof(long long));
+            push_inst_r_i(program, MOVI, R3, 2 * sizeof(long long));
+            push_inst_r_r_r_i(program, FSTXR, R2, R3, R2, sizeof(double));
         }
         compileExpr(program, expr->v.binary_expr->x);
-        if (expr->v.binary_expr->x->kind == ParenExpr_kind || expr->v.binary_expr->x->kind == BinaryExpr_kind) {
+        if (keep_y) {
             shift_registers(program);
             push_inst_r_i(program, REF_ALLOCAI, R2, addr);
-            push_inst_r_r_i(program, LDR, R5, R2, sizeof(long long));
+            push_inst_r_r_i(program, LDR, R4, R2, sizeof(long long));
+            push_inst_r_i(program, MOVI, R3, sizeof(long long));
+            push_inst_r_r_r_i(program, LDXR, R5, R2, R3, sizeof(long long));
+            push_inst_r_i(program, MOVI, R3, 2 * sizeof(long long));
+            push_inst_r_r_r_i(program, FLDXR, R2, R2, R3, sizeof(double));
         }
         switch (expr->v.binary_expr->op) {
         case ADD_tok:
@@ -629,32 +680,26 @@ unsigned short compileExpr(KaosIR* program, Expr* expr)
         return compileExpr(program, expr->v.paren_expr->x);
         break;
     case IndexExpr_kind: {
-        enum ValueType type1 = compileExpr(program, expr->v.index_expr->x) - 1;
+        enum ValueType type1;
+        Symbol* symbol = NULL;
+        if (expr->v.index_expr->x->kind == Ident_kind)
+            symbol = getSymbol(expr->v.index_expr->x->v.ident->name);
+        if (symbol != NULL && symbol->type == K_STRING && symbol->value_type == V_STRING) {
+            // A character is copied out, the cell keeps its builder
+            peek_string(program, symbol);
+            type1 = V_STRING;
+        } else {
+            type1 = compileExpr(program, expr->v.index_expr->x) - 1;
+        }
         shift_registers(program);
 
         compileExpr(program, expr->v.index_expr->index);
         push_inst_r_r(program, MOVR, R11, R1);
         switch (type1) {
         case V_STRING: {
+            // The character is an inline string, no allocation needed
             push_inst_(program, DYN_STR_INDEX_ACCESS);
             push_inst_r_i(program, MOVI, R0, V_STRING);
-
-            i64 len = 1;
-            i64 addr = stack_counter++;
-            push_inst_i_i(program, ALLOCAI, addr, (len + 1) * sizeof(char) + sizeof(size_t));
-            push_inst_r_i(program, REF_ALLOCAI, R1, addr);
-
-            push_inst_r_i(program, MOVI, R2, sizeof(size_t));
-            push_inst_r_i(program, MOVI, R3, len);
-            push_inst_r_r_r_i(program, STXR, R1, R2, R3, sizeof(size_t));
-
-            push_inst_r_i(program, MOVI, R2, 0 * sizeof(char) + sizeof(size_t));
-            push_inst_r_r_r_i(program, LDXR, R3, R5, R4, sizeof(char));
-            push_inst_r_r_r_i(program, STXR, R1, R2, R3, sizeof(char));
-
-            push_inst_r_i(program, MOVI, R2, len * sizeof(char) + sizeof(size_t));
-            push_inst_r_i(program, MOVI, R3, '\0');
-            push_inst_r_r_r_i(program, STXR, R1, R2, R3, sizeof(char));
             break;
         }
         case V_LIST:
@@ -670,11 +715,51 @@ unsigned short compileExpr(KaosIR* program, Expr* expr)
             break;
         }
 
-        // R5 holds to pointer to size_t + string + '\n'
-        // R4 holds size to the place size_t + N number of chars
+        // R6 holds the address of the indexed variable's cell
+        // R11 holds the index
         return type1 + 1;
         break;
     }
+    case SliceExpr_kind: {
+        SliceExpr* slice_expr = expr->v.slice_expr;
+        if (slice_expr->x->kind == Ident_kind) {
+            Symbol* symbol = getSymbol(slice_expr->x->v.ident->name);
+            if (symbol->value_type != V_STRING)
+                throw_error(E_UNRECOGNIZED_COMPLEX_DATA_TYPE, getTypeName(symbol->type), symbol->name);
+        }
+
+        // Keep the string and the lower bound on the stack while the bounds are compiled
+        i64 addr = stack_counter++;
+        push_inst_i_i(program, ALLOCAI, addr, 2 * sizeof(long long));
+        compileExpr(program, slice_expr->x);
+        push_inst_r_i(program, REF_ALLOCAI, R2, addr);
+        push_inst_r_r_i(program, STR, R2, R1, sizeof(long long));
+
+        if (slice_expr->low != NULL)
+            compileExpr(program, slice_expr->low);
+        else
+            push_inst_r_i(program, MOVI, R1, 0);
+        push_inst_r_i(program, REF_ALLOCAI, R2, addr);
+        push_inst_r_i(program, MOVI, R3, sizeof(long long));
+        push_inst_r_r_r_i(program, STXR, R2, R3, R1, sizeof(long long));
+
+        if (slice_expr->high != NULL)
+            compileExpr(program, slice_expr->high);
+        else
+            push_inst_r_i(program, MOVI, R1, CPU_STRING_SLICE_END);
+        push_inst_r_r(program, MOVR, R5, R1);
+
+        push_inst_r_i(program, REF_ALLOCAI, R2, addr);
+        push_inst_r_i(program, MOVI, R3, sizeof(long long));
+        push_inst_r_r_r_i(program, LDXR, R4, R2, R3, sizeof(long long));
+        push_inst_r_r_i(program, LDR, R1, R2, sizeof(long long));
+
+        // Long slices are views into the string, nothing is copied
+        push_inst_(program, DYN_STR_SLICE);
+        push_inst_r_i(program, MOVI, R0, V_STRING);
+        return V_STRING + 1;
+        break;
+    }
     case IncDecExpr_kind: {
         enum ValueType type = compileExpr(program, expr->v.incdec_expr->x);
         switch (expr->v.incdec_expr->op) {
@@ -713,25 +798,75 @@ unsigned short compileExpr(KaosIR* program, Expr* expr)
     }
     case CompositeLit_kind: {
         /*
-          0      8              size+8
-          +------+ +-----------------+
-          | size | |    elements     |
-          +------+ +-----------------+
-           size_t      size * i64
-                        ref (list)
-                    key-value (dict)
+          0      8          16     24      32           40             size*8+40
+          +------+----------+------+-------+------------+ +-----------------+
+          | size | capacity | head | items | value_type | |    elements     |
+          +------+----------+------+-------+------------+ +-----------------+
+           size_t  size_t    size_t  i64*       i64           size * i64
+                                                          ref or value (list)
+
+          Dictionaries have a different header, see `cpu_dict` in vm/cpu.h
         */
         ExprList* expr_list = expr->v.composite_lit->elts;
         enum ValueType value_type = expr->v.composite_lit->type->kind == ListType_kind ? V_LIST : V_DICT;
+        enum ValueType unboxed_type = get_unboxed_value_type(expr_list);
+        size_t header_size = value_type == V_DICT ? sizeof(cpu_dict) : sizeof(cpu_list);
         i64 list_addr = stack_counter++;
-        push_inst_i_i(program, ALLOCAI, list_addr, sizeof(size_t) + expr_list->expr_count * sizeof(long long));
+        push_inst_i_i(program, ALLOCAI, list_addr, header_size + expr_list->expr_count * sizeof(long long));
         push_inst_r_i(program, REF_ALLOCAI, R10, list_addr);
         push_inst_r_i(program, MOVI, R3, expr_list->expr_count);
         push_inst_r_r_i(program, STR, R10, R3, sizeof(size_t));
+        if (value_type == V_DICT) {
+            // See `cpu_dict` in vm/cpu.h
+            push_inst_r_i(program, MOVI, R2, offsetof(cpu_dict, used));
+            push_inst_r_r_r_i(program, STXR, R10, R2, R3, sizeof(size_t));
+            push_inst_r_i(program, MOVI, R2, offsetof(cpu_dict, capacity));
+            push_inst_r_r_r_i(program, STXR, R10, R2, R3, sizeof(size_t));
+            push_inst_r_r_i(program, ADDI, R3, R10, sizeof(cpu_dict));
+            push_inst_r_i(program, MOVI, R2, offsetof(cpu_dict, entries));
+            push_inst_r_r_r_i(program, STXR, R10, R2, R3, sizeof(i64));
+            push_inst_r_i(program, MOVI, R3, 0);
+            push_inst_r_i(program, MOVI, R2, offsetof(cpu_dict, index));
+            push_inst_r_r_r_i(program, STXR, R10, R2, R3, sizeof(i64));
+            push_inst_r_i(program, MOVI, R3, unboxed_type);
+            push_inst_r_i(program, MOVI, R2, offsetof(cpu_dict, value_type));
+            push_inst_r_r_r_i(program, STXR, R10, R2, R3, sizeof(i64));
+        } else {
+            // See `cpu_list` in vm/cpu.h
+            push_inst_r_i(program, MOVI, R2, offsetof(cpu_list, capacity));
+            push_inst_r_r_r_i(program, STXR, R10, R2, R3, sizeof(size_t));
+            push_inst_r_i(program, MOVI, R3, 0);
+            push_inst_r_i(program, MOVI, R2, offsetof(cpu_list, head));
+            push_inst_r_r_r_i(program, STXR, R10, R2, R3, sizeof(size_t));
+            push_inst_r_r_i(program, ADDI, R3, R10, sizeof(cpu_list));
+            push_inst_r_i(program, MOVI, R2, offsetof(cpu_list, items));
+            push_inst_r_r_r_i(program, STXR, R10, R2, R3, sizeof(i64));
+            push_inst_r_i(program, MOVI, R3, unboxed_type);
+            push_inst_r_i(program, MOVI, R2, offsetof(cpu_list, value_type));
+            push_inst_r_r_r_i(program, STXR, R10, R2, R3, sizeof(i64));
+        }
         size_t j = 0;
         for (size_t i = expr_list->expr_count; 0 < i; i--) {
             compileExpr(program, expr_list->exprs[i - 1]);
             Expr* expr = expr_list->exprs[i - 1];
+
+            // Unboxed list elements are stored right into their slots
+            if (value_type == V_LIST && unboxed_type != V_ANY) {
+                push_inst_r_i(program, REF_ALLOCAI, R10, list_addr);
+                push_inst_r_i(program, MOVI, R3, header_size + (j++) * sizeof(long long));
+                if (unboxed_type == V_FLOAT)
+                    push_inst_r_r_r_i(program, FSTXR, R10, R3, R1, sizeof(double));
+                else
+                    push_inst_r_r_r_i(program, STXR, R10, R3, R1, sizeof(long long));
+                continue;
+            }
+
+            // Unboxed dictionary values replace the value cell in the pair
+            if (value_type == V_DICT && unboxed_type != V_ANY) {
+                push_inst_r_i(program, MOVI, R3, sizeof(long long));
+                push_inst_r_r_r_i(program, LDXR, R1, R1, R3, sizeof(long long));
+            }
+
             i64 elt_addr = stack_counter++;
 
             switch (expr->kind) {
@@ -777,7 +912,7 @@ unsigned short compileExpr(KaosIR* program, Expr* expr)
             //     value_type = V_DICT;
             // }
             push_inst_r_i(program, REF_ALLOCAI, R10, list_addr);
-            push_inst_r_i(program, MOVI, R3, sizeof(size_t) + (j++) * sizeof(long long));
+            push_inst_r_i(program, MOVI, R3, header_size + (j++) * sizeof(long long));
             push_inst_r_r_r_i(program, STXR, R10, R3, R2, sizeof(long long));
         }
         // compileSpec(program, expr->v.composite_lit->type);
@@ -826,6 +961,10 @@ unsigned short compileExpr(KaosIR* program, Expr* expr)
         break;
     }
     case CallExpr_kind: {
+        BuiltinFunction* builtin = get_builtin_function(expr->v.call_expr->fun);
+        if (builtin != NULL)
+            return compile_builtin_call(program, builtin, expr->v.call_expr->args);
+
         _Function* function = NULL;
         switch (expr->v.call_expr->fun->kind) {
         case Ident_kind:
@@ -1512,12 +1651,10 @@ void compileDecl(KaosIR* program, Decl* decl)
             );
         }
 
-        // Don't worry `V_LIST` was intentional
-        push_inst_r_i(program, MOVI, R0, V_LIST);
         push_inst_r_i(program, REF_ALLOCAI, R2, addr);
         push_inst_r_r_i(program, LDR, R1, R2, sizeof(i64));
 
-        push_inst_r_r_r(program, DYN_COMP_ACCESS, R1, R0, R11);
+        push_inst_r_r(program, DYN_DICT_ENTRY_ACCESS, R1, R11);
         push_inst_r_r_i(program, LDR, R11, R2, sizeof(long long));
         push_inst_r_i(program, MOVI, R3, sizeof(long long));
         push_inst_r_r_r_i(program, LDXR, R12, R2, R3, sizeof(long long));
@@ -2573,6 +2710,13 @@ void load_float(KaosIR* program, Symbol* symbol)
 }
 
 void load_string(KaosIR* program, Symbol* symbol)
+{
+    peek_string(program, symbol);
+    // The string may be referenced from elsewhere from now on
+    push_inst_(program, DYN_STR_SHARE);
+}
+
+void peek_string(KaosIR* program, Symbol* symbol)
 {
     i64 addr = symbol->addr;
     push_inst_r_i(program, REF_ALLOCAI, R2, addr);
@@ -2945,3 +3089,132 @@ void strongly_type_basic_check(unsigned short code, char *str1, char *str2, enum
         break;
     }
 }
+
+size_t count_string_concat_operands(Expr* expr)
+{
+    switch (expr->kind) {
+    case BinaryExpr_kind: {
+        if (expr->v.binary_expr->op != ADD_tok)
+            return 0;
+        size_t x_count = count_string_concat_operands(expr->v.binary_expr->x);
+        size_t y_count = count_string_concat_operands(expr->v.binary_expr->y);
+        if (x_count == 0 || y_count == 0)
+            return 0;
+        return x_count + y_count;
+    }
+    case BasicLit_kind:
+        return expr->v.basic_lit->value_type == V_STRING ? 1 : 0;
+    case Ident_kind: {
+        Symbol* symbol = getSymbol(expr->v.ident->name);
+        return symbol->type == K_STRING && symbol->value_type == V_STRING ? 1 : 0;
+    }
+    default:
+        return 0;
+    }
+}
+
+void compile_string_concat_operands(KaosIR* program, Expr* expr, i64 addr, size_t* i)
+{
+    if (expr->kind == BinaryExpr_kind) {
+        compile_string_concat_operands(program, expr->v.binary_expr->x, addr, i);
+        compile_string_concat_operands(program, expr->v.binary_expr->y, addr, i);
+        return;
+    }
+
+    compileExpr(program, expr);
+    push_inst_r_i(program, REF_ALLOCAI, R2, addr);
+    push_inst_r_i(program, MOVI, R3, (*i)++ * sizeof(i64));
+    push_inst_r_r_r_i(program, STXR, R2, R3, R1, sizeof(i64));
+}
+
+BuiltinFunction* get_builtin_function(Expr* fun)
+{
+    if (fun->kind != Ident_kind)
+        return NULL;
+
+    char *name = fun->v.ident->name;
+    for (unsigned short i = 0; i < BUILTIN_FUNCTIONS_LENGTH; i++) {
+        if (strcmp(builtin_functions[i].name, name) != 0)
+            continue;
+
+        // A function of the same name that is defined by the program takes precedence
+        if (checkDuplicateFunction(name, module_path_stack.arr[module_path_stack.size - 1]) != NULL)
+            return NULL;
+        return &builtin_functions[i];
+    }
+
+    return NULL;
+}
+
+unsigned short compile_builtin_call(KaosIR* program, BuiltinFunction* builtin, ExprList* args)
+{
+    if (args->expr_count != builtin->params_length)
+        throw_error(E_INCORRECT_FUNCTION_ARGUMENT_COUNT, builtin->name);
+
+    // The arguments are passed to the CPU as an array of value words, the parser stores them last to first
+    i64 addr = stack_counter++;
+    push_inst_i_i(program, ALLOCAI, addr, builtin->params_length * sizeof(i64));
+    for (unsigned short i = 0; i < builtin->params_length; i++) {
+        enum ValueType value_type = compileExpr(program, args->exprs[builtin->params_length - 1 - i]) - 1;
+        enum ValueType param = builtin->params[i];
+
+        if (param == V_INT && value_type == V_FLOAT)
+            push_inst_r_r(program, TRUNCR, R1, R1);
+        else if (value_type != param && value_type != V_ANY)
+            throw_error(E_ILLEGAL_VARIABLE_TYPE_FOR_FUNCTION_PARAMETER, builtin->param_names[i], builtin->name);
+
+        push_inst_r_i(program, REF_ALLOCAI, R2, addr);
+        push_inst_r_i(program, MOVI, R3, i * sizeof(i64));
+        push_inst_r_r_r_i(program, STXR, R2, R3, R1, sizeof(i64));
+    }
+
+    push_inst_r_i(program, REF_ALLOCAI, R1, addr);
+    push_inst_r(program, builtin->op_code, R1);
+    push_inst_r_i(program, MOVI, R0, builtin->value_type);
+    return builtin->value_type + 1;
+}
+
+bool is_string_append(AssignStmt* assign_stmt)
+{
+    if (assign_stmt->x->kind != Ident_kind || assign_stmt->y->kind != BinaryExpr_kind)
+        return false;
+
+    BinaryExpr* binary_expr = assign_stmt->y->v.binary_expr;
+    if (binary_expr->op != ADD_tok || binary_expr->x->kind != Ident_kind)
+        return false;
+    if (strcmp(binary_expr->x->v.ident->name, assign_stmt->x->v.ident->name) != 0)
+        return false;
+
+    Symbol* symbol = getSymbol(assign_stmt->x->v.ident->name);
+    if (symbol->type != K_STRING || symbol->value_type != V_STRING)
+        return false;
+
+    // The appended operand has to be known to be a string at compile time
+    switch (binary_expr->y->kind) {
+    case BasicLit_kind:
+        return binary_expr->y->v.basic_lit->value_type == V_STRING;
+    case Ident_kind: {
+        Symbol* symbol_y = getSymbol(binary_expr->y->v.ident->name);
+        return symbol_y->type == K_STRING && symbol_y->value_type == V_STRING;
+    }
+    default:
+        return false;
+    }
+}
+
+enum ValueType get_unboxed_value_type(ExprList* expr_list)
+{
+    // Elements are stored unboxed only if they are all literals of the same scalar type
+    enum ValueType value_type = V_ANY;
+    for (unsigned long i = 0; i < expr_list->expr_count; i++) {
+        Expr* expr = expr_list->exprs[i];
+        if (expr->kind == KeyValueExpr_kind)
+            expr = expr->v.key_value_expr->value;
+        if (expr->kind != BasicLit_kind)
+            return V_ANY;
+        if (i > 0 && expr->v.basic_lit->value_type != value_type)
+            return V_ANY;
+        value_type = expr->v.basic_lit->value_type;
+    }
+    return value_type;
+}
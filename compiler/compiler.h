@@ -27,6 +27,25 @@
 #include "../ast/ast.h"
 #include "../interpreter/module_new.h"
 
+/*
+  join, split, replace and repeat are compiled into single instructions
+  unless the program defines a function with the same name. The arguments
+  are type checked at compile time, params holds their value types.
+*/
+#define BUILTIN_FUNCTIONS_LENGTH 4
+#define BUILTIN_FUNCTION_MAX_PARAMS 3
+
+typedef struct BuiltinFunction {
+    char *name;
+    enum IROpCode op_code;
+    unsigned short params_length;
+    enum ValueType params[BUILTIN_FUNCTION_MAX_PARAMS];
+    char *param_names[BUILTIN_FUNCTION_MAX_PARAMS];
+    enum ValueType value_type;
+} BuiltinFunction;
+
+BuiltinFunction builtin_functions[BUILTIN_FUNCTIONS_LENGTH];
+
 KaosIR* compile(ASTRoot* ast_root);
 void initCallJumps();
 void fillCallJumps(KaosIR* program);
@@ -71,6 +90,7 @@ void load_bool(KaosIR* program, Symbol* symbol);
 void load_int(KaosIR* program, Symbol* symbol);
 void load_float(KaosIR* program, Symbol* symbol);
 void load_string(KaosIR* program, Symbol* symbol);
+void peek_string(KaosIR* program, Symbol* symbol);
 void load_list(KaosIR* program, Symbol* symbol);
 void load_dict(KaosIR* program, Symbol* symbol);
 void load_any(KaosIR* program, Symbol* symbol);
@@ -86,6 +106,12 @@ bool does_stmt_have_a_call(Stmt* stmt, _Function* function);
 
 void strongly_type(Symbol* symbol_x, Symbol* symbol_y, _Function* function, Expr* expr, enum ValueType value_type);
 void strongly_type_basic_check(unsigned short code, char *str1, char *str2, enum Type type, enum ValueType value_type);
+size_t count_string_concat_operands(Expr* expr);
+void compile_string_concat_operands(KaosIR* program, Expr* expr, i64 addr, size_t* i);
+BuiltinFunction* get_builtin_function(Expr* fun);
+unsigned short compile_builtin_call(KaosIR* program, BuiltinFunction* builtin, ExprList* args);
+bool is_string_append(AssignStmt* assign_stmt);
+enum ValueType get_unboxed_value_type(ExprList* expr_list);
 
 cpu *interactive_c;
 
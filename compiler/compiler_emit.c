@@ -379,10 +379,45 @@ void emitBytecode(cpu *c)
     case DYN_COMP_ACCESS:
         sprintf(str_inst, "%s addr: R(%d) R(%d) R(%d)", "DYN_COMP_ACCESS", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->reg);
         break;
+    case DYN_DICT_ENTRY_ACCESS:
+        sprintf(str_inst, "%s addr: R(%d) R(%d)", "DYN_DICT_ENTRY_ACCESS", c->inst->op1->reg, c->inst->op2->reg);
+        break;
     // Dynamic Index Update
+    case DYN_STR_INDEX_UPDATE:
+        sprintf(str_inst, "%s", "DYN_STR_INDEX_UPDATE");
+        break;
     case DYN_LIST_INDEX_UPDATE:
         sprintf(str_inst, "%s", "DYN_LIST_INDEX_UPDATE");
         break;
+    // Dynamic String Append
+    case DYN_STR_APPEND:
+        sprintf(str_inst, "%s", "DYN_STR_APPEND");
+        break;
+    case DYN_STR_SHARE:
+        sprintf(str_inst, "%s", "DYN_STR_SHARE");
+        break;
+    case DYN_STR_CONCAT:
+        sprintf(str_inst, "%s R(%d) %lld", "DYN_STR_CONCAT", c->inst->op1->reg, c->inst->op2->value.i);
+        break;
+    case DYN_STR_SLICE:
+        sprintf(str_inst, "%s", "DYN_STR_SLICE");
+        break;
+    case DYN_STR_JOIN:
+        sprintf(str_inst, "%s R(%d)", "DYN_STR_JOIN", c->inst->op1->reg);
+        break;
+    case DYN_STR_SPLIT:
+        sprintf(str_inst, "%s R(%d)", "DYN_STR_SPLIT", c->inst->op1->reg);
+        break;
+    case DYN_STR_REPLACE:
+        sprintf(str_inst, "%s R(%d)", "DYN_STR_REPLACE", c->inst->op1->reg);
+        break;
+    case DYN_STR_REPEAT:
+        sprintf(str_inst, "%s R(%d)", "DYN_STR_REPEAT", c->inst->op1->reg);
+        break;
+    // Dynamic List Append
+    case DYN_LIST_APPEND:
+        sprintf(str_inst, "%s", "DYN_LIST_APPEND");
+        break;
     // Dynamic Type Conversion
     case DYN_BOOL_TO_STR:
         sprintf(str_inst, "%s", "DYN_BOOL_TO_STR");
@@ -23,7 +23,7 @@
 #ifndef KAOS_ENUMS_H
 #define KAOS_ENUMS_H
 
-enum Phase { INIT_PREPARSE, PREPARSE, INIT_PROGRAM, PROGRAM, INIT_JSON_PARSE, JSON_PARSE };
+enum Phase { INIT_PREPARSE, PREPARSE, INIT_PROGRAM, PROGRAM };
 
 enum Type { K_VOID, K_BOOL, K_NUMBER, K_STRING, K_ANY, K_LIST, K_DICT };
 enum ValueType { V_BOOL, V_INT, V_FLOAT, V_STRING, V_ANY, V_VOID, V_LIST, V_DICT, V_REF };
@@ -50,6 +50,11 @@ void throw_error_base(
     char bg_color[3];
     int indent = 2;
 
+    // Whatever the program printed so far comes before the error
+    if (cpu_output != NULL)
+        cpu_output_redirect(cpu_output);
+    cpu_output_flush();
+
     sprintf(bg_color, "41");
     sprintf(title_msg, "%*c%s Error (most recent call last):", indent, ' ', __KAOS_LANGUAGE_NAME__);
 
@@ -150,6 +155,12 @@ void throw_error_base(
     case E_STACK_OVERFLOW:
         sprintf(error_msg, "Stack overflow! Report this error to https://github.com/chaos-lang/chaos/issues");
         break;
+    case E_INVALID_JSON:
+        sprintf(error_msg, "Invalid JSON at position: %lld", lld1);
+        break;
+    case E_STRING_LENGTH_OVERFLOW:
+        sprintf(error_msg, "Repeating a string of length %llu, %lld times overflows the string length!", llu1, lld1);
+        break;
     default:
         sprintf(error_msg, "Unkown error.");
         break;
@@ -214,7 +225,7 @@ void throw_error_base(
         free(line);
     }
 
-    if (code == E_INDEX_OUT_OF_RANGE || code == E_INDEX_OUT_OF_RANGE_STRING)
+    if ((code == E_INDEX_OUT_OF_RANGE || code == E_INDEX_OUT_OF_RANGE_STRING) && ast_stack != NULL)
         // Runtime error
         current_ast = (void *)ast_stack[ast_stack_p];
     else
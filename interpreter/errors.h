@@ -31,6 +31,7 @@
 
 #include "../utilities/language.h"
 #include "function.h"
+#include "../vm/output.h"
 
 enum ExitCode {
     E_SUCCESS,
@@ -68,6 +69,8 @@ enum ExitCode {
     E_BREAK_CALL_OUTSIDE_LOOP,
     E_BREAK_CALL_MULTILINE_LOOP,
     E_STACK_OVERFLOW,
+    E_INVALID_JSON,
+    E_STRING_LENGTH_OVERFLOW,
     E_PREEMPTIVE
 };
 
@@ -80,6 +80,8 @@ void initKaosApi() {
     kaos.getRole = getRole;
     kaos.raiseError = raiseError;
     kaos.parseJson = parseJson;
+    kaos.dumpVariableToStringWithLength = dumpVariableToStringWithLength;
+    kaos.dumpVariableToStream = dumpVariableToStream;
 }
 
 void callRegisterInDynamicLibrary(char* dynamic_library_path) {
@@ -98,6 +100,8 @@ void callFunctionFromDynamicLibrary(_Function* function, cpu* c) {
     dynamic_library dylib = getFunctionFromDynamicLibrary(function->module_context, function_name);
     startFunctionScope(function);
     populateCallParametersDynamicLibrary(function, c);
+    // Spells write to the standard streams on their own, what is printed so far comes first
+    cpu_output_flush();
     dylib.func();
     handleFunctionReturnDynamicLibrary(function, c);
     removeSymbolsByScope(getCurrentScope());
@@ -23,7 +23,6 @@
 #include "function.h"
 
 extern int kaos_lineno;
-extern int yyparse();
 
 bool decision_execution_mode = false;
 
@@ -48,9 +47,7 @@ void startFunction(char *name, enum Type type, enum Type secondary_type) {
 
     removeFunctionIfDefined(name);
     function_mode = (struct _Function*)calloc(1, sizeof(_Function));
-    function_mode->name = malloc(1 + strlen(name));
-
-    strcpy(function_mode->name, name);
+    function_mode->name = intern_name(name, strlen(name));
     function_mode->type = type;
     function_mode->secondary_type = secondary_type;
     function_mode->parameter_count = 0;
@@ -101,6 +98,7 @@ void startFunction(char *name, enum Type type, enum Type secondary_type) {
         end_function = function_mode;
         end_function->next = NULL;
     }
+    mapFunction(function_mode);
 
     function_mode->parameters = realloc(
         function_mode->parameters,
@@ -145,11 +143,10 @@ void startFunction(char *name, enum Type type, enum Type secondary_type) {
 
 _Function* declareFunction(char *name, char *module, char *module_path, char *context, enum Type type, enum Type secondary_type) {
     _Function* function = (struct _Function*)calloc(1, sizeof(_Function));
-    function->name = malloc(1 + strlen(name));
+    function->name = intern_name(name, strlen(name));
     function->is_compiled = false;
     function->ref = NULL;
 
-    strcpy(function->name, name);
     function->type = type;
     function->secondary_type = secondary_type;
     function->parameters = NULL;
@@ -176,6 +173,7 @@ _Function* declareFunction(char *name, char *module, char *module_path, char *co
         end_function = function;
         end_function->next = NULL;
     }
+    mapFunction(function);
 
     function->call_patches = (int*)malloc(USHRT_MAX * 256 * sizeof(int));
     function->call_patches_size = 0;
@@ -190,6 +188,7 @@ void startFunctionScope(_Function* function) {
         function_call = (struct FunctionCall*)malloc(sizeof(FunctionCall));
         function_call->start_symbol = NULL;
         function_call->end_symbol = NULL;
+        initSymbolMap(&function_call->symbols);
     } else {
         function_call = function_call_start;
     }
@@ -254,24 +253,56 @@ void resetFunctionParametersMode() {
     freeFunctionParametersMode();
 }
 
-_Function* getFunction(char *name, char *module) {
-    function_cursor = start_function;
-    while (function_cursor != NULL) {
-        if (module == NULL && strcmp(function_cursor->module, "") != 0) {
-            function_cursor = function_cursor->next;
-            continue;
-        }
-        bool criteria = function_cursor->name != NULL && strcmp(function_cursor->name, name) == 0;
-        criteria = criteria && (
-            strcmp(function_cursor->context, module_path_stack.arr[module_path_stack.size - 1]) == 0
-        );
-        if (module != NULL) criteria = criteria && strcmp(function_cursor->module, module) == 0;
-        if (criteria) {
-            _Function* function = function_cursor;
+static unsigned long long hashFunctionKey(char *name, char *module, char *context) {
+    unsigned long long hash = intern_hash_bytes(name, strlen(name));
+    if (module != NULL)
+        hash = (hash ^ intern_hash_bytes(module, strlen(module))) * 1099511628211ULL;
+    return (hash ^ intern_hash_bytes(context, strlen(context))) * 1099511628211ULL;
+}
+
+static bool functionHasKey(_Function* function, enum FunctionMapKey key, char *name, char *module, char *context) {
+    if (function->name != name && strcmp(function->name, name) != 0)
+        return false;
+    if (key == FUNCTION_MAP_MODULE_CONTEXT)
+        return strcmp(function->module_context, context) == 0;
+    return strcmp(function->module, module) == 0 && strcmp(function->context, context) == 0;
+}
+
+static _Function* findFunctionInChain(
+    _Function* function,
+    enum FunctionMapKey key,
+    unsigned long long hash,
+    char *name,
+    char *module,
+    char *context
+) {
+    while (function != NULL) {
+        if (function->key_hashes[key] == hash && functionHasKey(function, key, name, module, context))
             return function;
-        }
-        function_cursor = function_cursor->next;
+        function = function->hash_next[key];
     }
+    return NULL;
+}
+
+static _Function* findFunctionByKey(enum FunctionMapKey key, char *name, char *module, char *context) {
+    function_map* map = &function_maps[key];
+    if (map->size == 0)
+        return NULL;
+
+    unsigned long long hash = hashFunctionKey(name, module, context);
+    return findFunctionInChain(map->buckets[hash & (map->capacity - 1)], key, hash, name, module, context);
+}
+
+_Function* getFunction(char *name, char *module) {
+    _Function* function = findFunctionByKey(
+        FUNCTION_MAP_CONTEXT,
+        name,
+        module == NULL ? "" : module,
+        module_path_stack.arr[module_path_stack.size - 1]
+    );
+    if (function != NULL)
+        return function;
+
     if (phase == PROGRAM) {
         if (scope_override != NULL)
             free(scope_override);
@@ -285,17 +316,12 @@ _Function* getFunction(char *name, char *module) {
 }
 
 _Function* getFunctionByModuleContext(char *name, char *module_context) {
-    function_cursor = start_function;
-    while (function_cursor != NULL) {
-        bool criteria = function_cursor->name != NULL && strcmp(function_cursor->name, name) == 0;
-        if (criteria && module_context != NULL && (
-            strcmp(function_cursor->module_context, module_context) == 0
-        )) {
-            _Function* function = function_cursor;
+    if (module_context != NULL) {
+        _Function* function = findFunctionByKey(FUNCTION_MAP_MODULE_CONTEXT, name, NULL, module_context);
+        if (function != NULL)
             return function;
-        }
-        function_cursor = function_cursor->next;
     }
+
     if (phase == PROGRAM) {
         if (scope_override != NULL)
             free(scope_override);
@@ -309,39 +335,89 @@ _Function* getFunctionByModuleContext(char *name, char *module_context) {
 }
 
 _Function* checkDuplicateFunction(char *name, char *module_path) {
-    function_cursor = start_function;
-    while (function_cursor != NULL) {
-        if (
-            strcmp(function_cursor->name, name) == 0
-            &&
-            strcmp(function_cursor->module_context, module_path) == 0
-        ) {
-            _Function* function = function_cursor;
-            return function;
-        }
-
-        function_cursor = function_cursor->next;
-    }
-
-    return NULL;
+    return findFunctionByKey(FUNCTION_MAP_MODULE_CONTEXT, name, NULL, module_path);
 }
 
 void removeFunctionIfDefined(char *name) {
     unsigned short parent_context = 1;
     if (module_path_stack.size > 1) parent_context = 2;
 
-    function_cursor = start_function;
-    while (function_cursor != NULL) {
-        if (strcmp(function_cursor->name, name) == 0 &&
-            strcmp(function_cursor->context, module_path_stack.arr[module_path_stack.size - parent_context]) == 0 &&
-            strcmp(function_cursor->module_context, module_path_stack.arr[module_path_stack.size - 1]) == 0 &&
-            strcmp(function_cursor->module, module_stack.arr[module_stack.size - 1]) == 0
-        ) {
-            _Function* function = function_cursor;
-            removeFunction(function);
-            return;
+    char *context = module_path_stack.arr[module_path_stack.size - parent_context];
+    char *module_context = module_path_stack.arr[module_path_stack.size - 1];
+    char *module = module_stack.arr[module_stack.size - 1];
+
+    _Function* function = findFunctionByKey(FUNCTION_MAP_CONTEXT, name, module, context);
+    while (function != NULL && strcmp(function->module_context, module_context) != 0) {
+        function = findFunctionInChain(
+            function->hash_next[FUNCTION_MAP_CONTEXT],
+            FUNCTION_MAP_CONTEXT,
+            function->key_hashes[FUNCTION_MAP_CONTEXT],
+            name,
+            module,
+            context
+        );
+    }
+
+    if (function != NULL)
+        removeFunction(function);
+}
+
+static void appendToFunctionBucket(_Function** bucket, _Function* function, enum FunctionMapKey key) {
+    // Appending keeps the functions with the same key in their declaration order
+    function->hash_next[key] = NULL;
+    while (*bucket != NULL)
+        bucket = &(*bucket)->hash_next[key];
+    *bucket = function;
+}
+
+static void growFunctionMap(function_map* map, enum FunctionMapKey key) {
+    unsigned long capacity = map->capacity == 0 ? 16 : map->capacity * 2;
+    _Function** buckets = calloc(capacity, sizeof(_Function*));
+
+    for (unsigned long i = 0; i < map->capacity; i++) {
+        _Function* function = map->buckets[i];
+        while (function != NULL) {
+            _Function* next = function->hash_next[key];
+            appendToFunctionBucket(&buckets[function->key_hashes[key] & (capacity - 1)], function, key);
+            function = next;
+        }
+    }
+
+    free(map->buckets);
+    map->buckets = buckets;
+    map->capacity = capacity;
+}
+
+void mapFunction(_Function* function) {
+    function->key_hashes[FUNCTION_MAP_CONTEXT] = hashFunctionKey(function->name, function->module, function->context);
+    function->key_hashes[FUNCTION_MAP_MODULE_CONTEXT] = hashFunctionKey(function->name, NULL, function->module_context);
+
+    for (unsigned short key = 0; key < FUNCTION_MAP_KEY_COUNT; key++) {
+        function_map* map = &function_maps[key];
+        if (map->size >= map->capacity)
+            growFunctionMap(map, key);
+
+        appendToFunctionBucket(&map->buckets[function->key_hashes[key] & (map->capacity - 1)], function, key);
+        map->size++;
+    }
+}
+
+void unmapFunction(_Function* function) {
+    for (unsigned short key = 0; key < FUNCTION_MAP_KEY_COUNT; key++) {
+        function_map* map = &function_maps[key];
+        if (map->capacity == 0)
+            continue;
+
+        _Function** bucket = &map->buckets[function->key_hashes[key] & (map->capacity - 1)];
+        while (*bucket != NULL) {
+            if (*bucket == function) {
+                *bucket = function->hash_next[key];
+                function->hash_next[key] = NULL;
+                map->size--;
+                break;
+            }
+            bucket = &(*bucket)->hash_next[key];
         }
-        function_cursor = function_cursor->next;
     }
 }
 
@@ -495,6 +571,7 @@ void initMainFunction() {
     dummy_scope = (struct FunctionCall*)malloc(sizeof(FunctionCall));
     dummy_scope->start_symbol = NULL;
     dummy_scope->end_symbol = NULL;
+    initSymbolMap(&dummy_scope->symbols);
     initScopeless();
     initMainContext();
     initKaosApi();
@@ -510,10 +587,13 @@ void initScopeless() {
     scopeless = (struct FunctionCall*)malloc(sizeof(FunctionCall));
     scopeless->start_symbol = NULL;
     scopeless->end_symbol = NULL;
+    initSymbolMap(&scopeless->symbols);
     scopeless->function = scopeless_function;
 }
 
 void removeFunction(_Function* function) {
+    unmapFunction(function);
+
     _Function* previous_function = function->previous;
     _Function* next_function = function->next;
 
@@ -537,7 +617,6 @@ void removeFunction(_Function* function) {
 }
 
 void freeFunction(_Function* function) {
-    free(function->name);
     if (function->ref == NULL)
         free(function->parameters);
     for (unsigned i = 0; i < function->decision_functions.size; i++) {
@@ -551,6 +630,15 @@ void freeFunction(_Function* function) {
     free(function);
 }
 
+static void freeFunctionMaps() {
+    for (unsigned short key = 0; key < FUNCTION_MAP_KEY_COUNT; key++) {
+        free(function_maps[key].buckets);
+        function_maps[key].buckets = NULL;
+        function_maps[key].capacity = 0;
+        function_maps[key].size = 0;
+    }
+}
+
 void freeAllFunctions() {
     function_cursor = start_function;
     while (function_cursor != NULL) {
@@ -558,6 +646,7 @@ void freeAllFunctions() {
         function_cursor = function_cursor->next;
         freeFunction(function);
     }
+    freeFunctionMaps();
 }
 
 bool block(enum BlockType type) {
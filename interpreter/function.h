@@ -49,6 +49,9 @@ typedef struct Decl Decl;
 extern enum Phase phase;
 enum BlockType { B_EXPRESSION, B_FUNCTION };
 
+// The keys functions are looked up by: (name, module, context) and (name, module context)
+enum FunctionMapKey { FUNCTION_MAP_CONTEXT, FUNCTION_MAP_MODULE_CONTEXT, FUNCTION_MAP_KEY_COUNT };
+
 typedef struct _Function {
     char *name;
     struct Symbol** parameters;
@@ -76,8 +79,19 @@ typedef struct _Function {
     int call_patches_size;
     Decl* ast;
     bool should_inline;
+    unsigned long long key_hashes[FUNCTION_MAP_KEY_COUNT];
+    struct _Function* hash_next[FUNCTION_MAP_KEY_COUNT];
 } _Function;
 
+// The declared functions hashed by each key, into chains that keep the declaration order
+typedef struct function_map {
+    _Function** buckets;
+    unsigned long capacity;
+    unsigned long size;
+} function_map;
+
+function_map function_maps[FUNCTION_MAP_KEY_COUNT];
+
 _Function* function_cursor;
 _Function* start_function;
 _Function* end_function;
@@ -93,6 +107,7 @@ typedef struct FunctionCall {
     int lineno;
     Symbol* start_symbol;
     Symbol* end_symbol;
+    symbol_map symbols;
 #ifndef CHAOS_COMPILER
     bool dont_pop_module_stack;
 #endif
@@ -141,6 +156,8 @@ _Function* getFunction(char *name, char *module);
 _Function* getFunctionByModuleContext(char *name, char *module_context);
 _Function* checkDuplicateFunction(char *name, char *module_path);
 void removeFunctionIfDefined(char *name);
+void mapFunction(_Function* function);
+void unmapFunction(_Function* function);
 void printFunctionTable();
 
 void startFunctionParameters();
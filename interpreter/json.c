@@ -0,0 +1,406 @@
+/*
+ * Description: JSON module of the Chaos Programming Language's source
+ *
+ * Copyright (c) 2019-2021 Chaos Language Development Authority <info@chaos-lang.org>
+ *
+ * License: GNU General Public License v3.0
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors: M. Mert Yildiran <me@mertyildiran.com>
+ */
+
+#include "json.h"
+
+Symbol* parseJsonToSymbol(char *json, size_t len) {
+    json_parser parser;
+    parser.json = json;
+    parser.len = len;
+    parser.pos = 0;
+    parser.stack = NULL;
+    parser.depth = 0;
+    parser.capacity = 0;
+    parser.key = NULL;
+
+    Symbol* value = NULL;
+    for (;;) {
+        skipJsonWhitespace(&parser);
+        if (parser.pos == parser.len)
+            throwJsonError(&parser);
+
+        char c = parser.json[parser.pos];
+        if (c == '{' || c == '[') {
+            union Value container_value;
+            container_value.i = 0;
+            Symbol* container = newJsonSymbol(&parser, c == '{' ? K_DICT : K_LIST, container_value, V_VOID);
+            container->secondary_type = K_ANY;
+            pushJsonFrame(&parser, container);
+            parser.pos++;
+
+            skipJsonWhitespace(&parser);
+            if (parser.pos < parser.len && parser.json[parser.pos] == (c == '{' ? '}' : ']')) {
+                parser.pos++;
+                value = popJsonFrame(&parser);
+            } else {
+                if (c == '{')
+                    parseJsonKey(&parser);
+                continue;
+            }
+        } else {
+            value = parseJsonScalar(&parser);
+        }
+
+        // Attach the value to its container, closing the containers that end right after it
+        for (;;) {
+            if (parser.depth == 0)
+                break;
+
+            json_frame* frame = &parser.stack[parser.depth - 1];
+            appendJsonChild(frame, value);
+
+            skipJsonWhitespace(&parser);
+            if (parser.pos == parser.len)
+                throwJsonError(&parser);
+
+            char close = frame->container->type == K_DICT ? '}' : ']';
+            c = parser.json[parser.pos];
+            if (c == ',') {
+                parser.pos++;
+                if (frame->container->type == K_DICT)
+                    parseJsonKey(&parser);
+                break;
+            }
+            if (c != close)
+                throwJsonError(&parser);
+
+            parser.pos++;
+            value = popJsonFrame(&parser);
+        }
+
+        if (parser.depth == 0)
+            break;
+    }
+
+    skipJsonWhitespace(&parser);
+    if (parser.pos != parser.len)
+        throwJsonError(&parser);
+
+    free(parser.stack);
+    return value;
+}
+
+Symbol* parseJsonScalar(json_parser* parser) {
+    union Value value;
+    char c = parser->json[parser->pos];
+
+    switch (c) {
+    case '"':
+        value.s = parseJsonString(parser);
+        return newJsonSymbol(parser, K_STRING, value, V_STRING);
+    case 't':
+        if (!matchJsonLiteral(parser, "true", 4))
+            throwJsonError(parser);
+        value.b = true;
+        return newJsonSymbol(parser, K_BOOL, value, V_BOOL);
+    case 'f':
+        if (!matchJsonLiteral(parser, "false", 5))
+            throwJsonError(parser);
+        value.b = false;
+        return newJsonSymbol(parser, K_BOOL, value, V_BOOL);
+    case 'n':
+        if (!matchJsonLiteral(parser, "null", 4))
+            throwJsonError(parser);
+        value.i = 0;
+        return newJsonSymbol(parser, K_ANY, value, V_VOID);
+    default:
+        if (c == '-' || (c >= '0' && c <= '9'))
+            return parseJsonNumber(parser);
+        throwJsonError(parser);
+        return NULL;
+    }
+}
+
+char* parseJsonString(json_parser* parser) {
+    // Skip the opening quote
+    parser->pos++;
+
+    size_t span = cpu_bytes_scan_string(parser->json + parser->pos, parser->len - parser->pos);
+    size_t capacity = span + JSON_STRING_MIN_CAPACITY;
+    size_t size = 0;
+    char* s = malloc(capacity * sizeof(char));
+
+    for (;;) {
+        // Room for the plain characters, two encoded escape sequences and the null-terminator
+        if (size + span + 7 > capacity) {
+            while (size + span + 7 > capacity)
+                capacity *= 2;
+            s = realloc(s, capacity * sizeof(char));
+        }
+        memcpy(s + size, parser->json + parser->pos, span * sizeof(char));
+        size += span;
+        parser->pos += span;
+
+        if (parser->pos == parser->len) {
+            free(s);
+            throwJsonError(parser);
+        }
+
+        char c = parser->json[parser->pos++];
+        if (c == '"')
+            break;
+        if (c != '\\' || parser->pos == parser->len) {
+            free(s);
+            parser->pos--;
+            throwJsonError(parser);
+        }
+
+        c = parser->json[parser->pos++];
+        switch (c) {
+        case '"':
+        case '\\':
+        case '/':
+            s[size++] = c;
+            break;
+        case 'b':
+            s[size++] = '\b';
+            break;
+        case 'f':
+            s[size++] = '\f';
+            break;
+        case 'n':
+            s[size++] = '\n';
+            break;
+        case 'r':
+            s[size++] = '\r';
+            break;
+        case 't':
+            s[size++] = '\t';
+            break;
+        case 'u': {
+            unsigned code = parseJsonHex(parser);
+            // A surrogate pair encodes a single code point outside of the BMP
+            if (
+                code >= 0xd800 && code <= 0xdbff &&
+                parser->pos + 1 < parser->len &&
+                parser->json[parser->pos] == '\\' &&
+                parser->json[parser->pos + 1] == 'u'
+            ) {
+                parser->pos += 2;
+                unsigned low = parseJsonHex(parser);
+                if (low >= 0xdc00 && low <= 0xdfff) {
+                    code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+                } else {
+                    size += encodeUtf8(code, s + size);
+                    code = low;
+                }
+            }
+            size += encodeUtf8(code, s + size);
+            break;
+        }
+        default:
+            free(s);
+            parser->pos--;
+            throwJsonError(parser);
+            break;
+        }
+
+        span = cpu_bytes_scan_string(parser->json + parser->pos, parser->len - parser->pos);
+    }
+
+    s[size] = '\0';
+    return s;
+}
+
+Symbol* parseJsonNumber(json_parser* parser) {
+    char* start = parser->json + parser->pos;
+    char* p = start;
+    char* end = parser->json + parser->len;
+    bool negative = false;
+    bool integral = true;
+
+    if (*p == '-') {
+        negative = true;
+        p++;
+    }
+    if (p == end || *p < '0' || *p > '9') {
+        parser->pos = p - parser->json;
+        throwJsonError(parser);
+    }
+
+    // Accumulate the integer part, it becomes a float if it overflows
+    unsigned long long n = 0;
+    unsigned long long limit = negative ? (unsigned long long)LLONG_MAX + 1 : (unsigned long long)LLONG_MAX;
+    if (*p == '0') {
+        p++;
+    } else {
+        while (p < end && *p >= '0' && *p <= '9') {
+            unsigned digit = *p - '0';
+            if (n > (limit - digit) / 10)
+                integral = false;
+            else
+                n = n * 10 + digit;
+            p++;
+        }
+    }
+
+    if (p < end && *p == '.') {
+        integral = false;
+        p++;
+        if (p == end || *p < '0' || *p > '9') {
+            parser->pos = p - parser->json;
+            throwJsonError(parser);
+        }
+        while (p < end && *p >= '0' && *p <= '9')
+            p++;
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        integral = false;
+        p++;
+        if (p < end && (*p == '+' || *p == '-'))
+            p++;
+        if (p == end || *p < '0' || *p > '9') {
+            parser->pos = p - parser->json;
+            throwJsonError(parser);
+        }
+        while (p < end && *p >= '0' && *p <= '9')
+            p++;
+    }
+
+    parser->pos = p - parser->json;
+
+    union Value value;
+    if (integral) {
+        value.i = negative ? (long long)(0 - n) : (long long)n;
+        return newJsonSymbol(parser, K_NUMBER, value, V_INT);
+    }
+    value.f = strtod(start, NULL);
+    return newJsonSymbol(parser, K_NUMBER, value, V_FLOAT);
+}
+
+void parseJsonKey(json_parser* parser) {
+    skipJsonWhitespace(parser);
+    if (parser->pos == parser->len || parser->json[parser->pos] != '"')
+        throwJsonError(parser);
+    parser->key = parseJsonString(parser);
+
+    skipJsonWhitespace(parser);
+    if (parser->pos == parser->len || parser->json[parser->pos] != ':')
+        throwJsonError(parser);
+    parser->pos++;
+}
+
+unsigned parseJsonHex(json_parser* parser) {
+    if (parser->len - parser->pos < 4)
+        throwJsonError(parser);
+
+    unsigned code = 0;
+    for (unsigned i = 0; i < 4; i++) {
+        char c = parser->json[parser->pos];
+        code <<= 4;
+        if (c >= '0' && c <= '9')
+            code |= c - '0';
+        else if (c >= 'a' && c <= 'f')
+            code |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+            code |= c - 'A' + 10;
+        else
+            throwJsonError(parser);
+        parser->pos++;
+    }
+    return code;
+}
+
+size_t encodeUtf8(unsigned code, char* out) {
+    if (code < 0x80) {
+        out[0] = (char)code;
+        return 1;
+    }
+    if (code < 0x800) {
+        out[0] = (char)(0xc0 | (code >> 6));
+        out[1] = (char)(0x80 | (code & 0x3f));
+        return 2;
+    }
+    if (code < 0x10000) {
+        out[0] = (char)(0xe0 | (code >> 12));
+        out[1] = (char)(0x80 | ((code >> 6) & 0x3f));
+        out[2] = (char)(0x80 | (code & 0x3f));
+        return 3;
+    }
+    out[0] = (char)(0xf0 | (code >> 18));
+    out[1] = (char)(0x80 | ((code >> 12) & 0x3f));
+    out[2] = (char)(0x80 | ((code >> 6) & 0x3f));
+    out[3] = (char)(0x80 | (code & 0x3f));
+    return 4;
+}
+
+void skipJsonWhitespace(json_parser* parser) {
+    while (parser->pos < parser->len) {
+        char c = parser->json[parser->pos];
+        if (c != ' ' && c != '\n' && c != '\r' && c != '\t')
+            break;
+        parser->pos++;
+    }
+}
+
+bool matchJsonLiteral(json_parser* parser, char* literal, size_t len) {
+    if (parser->len - parser->pos < len || memcmp(parser->json + parser->pos, literal, len) != 0)
+        return false;
+    parser->pos += len;
+    return true;
+}
+
+Symbol* newJsonSymbol(json_parser* parser, enum Type type, union Value value, enum ValueType value_type) {
+    // The document itself belongs to the calling function, everything in it is scopeless like complex elements
+    FunctionCall* scope = parser->depth == 0 ? getCurrentScope() : scopeless;
+    Symbol* symbol = createSymbolInScope(scope, parser->key, type, value, value_type);
+    parser->key = NULL;
+    return symbol;
+}
+
+void pushJsonFrame(json_parser* parser, Symbol* container) {
+    if (parser->depth == parser->capacity) {
+        parser->capacity = parser->capacity == 0 ? JSON_STACK_MIN_CAPACITY : parser->capacity * 2;
+        parser->stack = realloc(parser->stack, parser->capacity * sizeof(json_frame));
+    }
+
+    json_frame* frame = &parser->stack[parser->depth++];
+    frame->container = container;
+    frame->children = NULL;
+    frame->count = 0;
+    frame->capacity = 0;
+}
+
+Symbol* popJsonFrame(json_parser* parser) {
+    json_frame* frame = &parser->stack[--parser->depth];
+    frame->container->children = frame->children;
+    frame->container->children_count = frame->count;
+    return frame->container;
+}
+
+void appendJsonChild(json_frame* frame, Symbol* child) {
+    if (frame->count == frame->capacity) {
+        frame->capacity = frame->capacity == 0 ? JSON_CHILDREN_MIN_CAPACITY : frame->capacity * 2;
+        frame->children = realloc(frame->children, frame->capacity * sizeof(Symbol*));
+    }
+    frame->children[frame->count++] = child;
+}
+
+void throwJsonError(json_parser* parser) {
+    // The symbols parsed so far are freed with their scopes, only the parser's own memory is released here
+    for (unsigned long i = 0; i < parser->depth; i++)
+        free(parser->stack[i].children);
+    free(parser->stack);
+    free(parser->key);
+    throw_error(E_INVALID_JSON, NULL, NULL, (long long)parser->pos);
+}
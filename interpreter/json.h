@@ -0,0 +1,82 @@
+/*
+ * Description: JSON module of the Chaos Programming Language's source
+ *
+ * Copyright (c) 2019-2021 Chaos Language Development Authority <info@chaos-lang.org>
+ *
+ * License: GNU General Public License v3.0
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors: M. Mert Yildiran <me@mertyildiran.com>
+ */
+
+#ifndef KAOS_JSON_H
+#define KAOS_JSON_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <limits.h>
+
+#include "../vm/bytes.h"
+#include "symbol.h"
+
+/*
+  `kaos.parseJson` parses JSON documents in a single pass straight into
+  symbols, the same lists and dictionaries a spell builds through the API.
+  Objects become dictionaries, arrays become lists and null becomes a void
+  value of type any. Integers that do not fit into 64 bits become floats.
+
+  Nested values are parsed without recursion, the open lists and
+  dictionaries are kept on an explicit stack with their children. The
+  plain characters of a string are scanned 16 or 32 bytes at a time and
+  copied at once, escape sequences are decoded in between.
+*/
+#define JSON_STACK_MIN_CAPACITY 16
+#define JSON_CHILDREN_MIN_CAPACITY 4
+#define JSON_STRING_MIN_CAPACITY 16
+
+typedef struct json_frame {
+    Symbol* container;
+    Symbol** children;
+    unsigned long count;
+    unsigned long capacity;
+} json_frame;
+
+typedef struct json_parser {
+    char* json;
+    size_t len;
+    size_t pos;
+    json_frame* stack;
+    unsigned long depth;
+    unsigned long capacity;
+    char* key;
+} json_parser;
+
+Symbol* parseJsonToSymbol(char *json, size_t len);
+Symbol* parseJsonScalar(json_parser* parser);
+char* parseJsonString(json_parser* parser);
+Symbol* parseJsonNumber(json_parser* parser);
+void parseJsonKey(json_parser* parser);
+unsigned parseJsonHex(json_parser* parser);
+size_t encodeUtf8(unsigned code, char* out);
+void skipJsonWhitespace(json_parser* parser);
+bool matchJsonLiteral(json_parser* parser, char* literal, size_t len);
+Symbol* newJsonSymbol(json_parser* parser, enum Type type, union Value value, enum ValueType value_type);
+void pushJsonFrame(json_parser* parser, Symbol* container);
+Symbol* popJsonFrame(json_parser* parser);
+void appendJsonChild(json_frame* frame, Symbol* child);
+void throwJsonError(json_parser* parser);
+
+#endif
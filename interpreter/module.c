@@ -21,6 +21,7 @@
  */
 
 #include "module.h"
+#include "module_new.h"
 
 extern bool interactively_importing;
 
@@ -51,44 +52,88 @@ void prependModuleToModuleBuffer(char *name) {
     prepend_to_array(&modules_buffer, name);
 }
 
-void moduleImportParse(char *module_path) {
-    if (
-        strcmp(
-            get_filename_ext(module_path),
-            __KAOS_DYNAMIC_LIBRARY_EXTENSION__
-        ) == 0
-    ) {
+void moduleImportParse(char *module_path, enum ModuleKind kind) {
+    if (kind == MODULE_DYNAMIC_LIBRARY) {
         callRegisterInDynamicLibrary(module_path);
     } else {
 #ifndef CHAOS_COMPILER
-        parseTheModuleContent(module_path);
+        queueModuleParse(_ast_root->files[_ast_root->file_count - 1]);
 #endif
     }
 }
 
-char* resolveModulePath(char *module_name, bool directly_import, char *parent_context) {
-    char *module_path;
-    char *relative_path = "";
+static unsigned long long hashModuleResolutionKey(char *parent_context, char *selector) {
+    unsigned long long hash = intern_hash_bytes(parent_context, strlen(parent_context));
+    return (hash ^ intern_hash_bytes(selector, strlen(selector))) * 1099511628211ULL;
+}
 
-    module_path = malloc(strlen(parent_context) + 1);
-    strcpy(module_path, parent_context);
-    if (strchr(module_path, __KAOS_PATH_SEPARATOR_ASCII__) == NULL) {
-        free(module_path);
-        module_path = "";
-    } else {
-        char *ptr = strrchr(module_path, __KAOS_PATH_SEPARATOR_ASCII__);
-        if (ptr) {
-            *ptr = '\0';
+static ModuleResolution* findModuleResolution(char *parent_context, char *selector) {
+    if (module_resolution_cache.size == 0)
+        return NULL;
+
+    unsigned long long hash = hashModuleResolutionKey(parent_context, selector);
+    ModuleResolution* resolution = module_resolution_cache.buckets[hash & (module_resolution_cache.capacity - 1)];
+    while (resolution != NULL) {
+        if (
+            resolution->hash == hash
+            &&
+            strcmp(resolution->parent_context, parent_context) == 0
+            &&
+            strcmp(resolution->selector, selector) == 0
+        )
+            return resolution;
+        resolution = resolution->next;
+    }
+    return NULL;
+}
+
+static void growModuleResolutionCache() {
+    unsigned long capacity = module_resolution_cache.capacity == 0 ? 16 : module_resolution_cache.capacity * 2;
+    ModuleResolution** buckets = calloc(capacity, sizeof(ModuleResolution*));
+
+    for (unsigned long i = 0; i < module_resolution_cache.capacity; i++) {
+        ModuleResolution* resolution = module_resolution_cache.buckets[i];
+        while (resolution != NULL) {
+            ModuleResolution* next = resolution->next;
+            resolution->next = buckets[resolution->hash & (capacity - 1)];
+            buckets[resolution->hash & (capacity - 1)] = resolution;
+            resolution = next;
         }
     }
 
-    if (module_path[0] != '\0') module_path = strcat_ext(module_path, __KAOS_PATH_SEPARATOR__);
+    free(module_resolution_cache.buckets);
+    module_resolution_cache.buckets = buckets;
+    module_resolution_cache.capacity = capacity;
+}
+
+static ModuleResolution* cacheModuleResolution(char *parent_context, char *selector, char *module_path) {
+    if (module_resolution_cache.size >= module_resolution_cache.capacity)
+        growModuleResolutionCache();
+
+    ModuleResolution* resolution = malloc(sizeof(ModuleResolution));
+    resolution->parent_context = strdup(parent_context);
+    resolution->selector = strdup(selector);
+    resolution->hash = hashModuleResolutionKey(parent_context, selector);
+    resolution->module_path = strdup(module_path);
+    resolution->kind = strcmp(
+        get_filename_ext(module_path),
+        __KAOS_DYNAMIC_LIBRARY_EXTENSION__
+    ) == 0 ? MODULE_DYNAMIC_LIBRARY : MODULE_KAOS;
+
+    ModuleResolution** bucket = &module_resolution_cache.buckets[resolution->hash & (module_resolution_cache.capacity - 1)];
+    resolution->next = *bucket;
+    *bucket = resolution;
+    module_resolution_cache.size++;
+    return resolution;
+}
+
+char* resolveModulePath(char *module_name, bool directly_import, char *parent_context, enum ModuleKind* kind) {
+    char *module_path;
+    char *relative_path = "";
 
     for (unsigned i = 0; i < modules_buffer.size; i++) {
-        module_path = strcat_ext(module_path, modules_buffer.arr[i]);
         relative_path = strcat_ext(relative_path, modules_buffer.arr[i]);
         if (i + 1 != modules_buffer.size) {
-            module_path = strcat_ext(module_path, __KAOS_PATH_SEPARATOR__);
             relative_path = strcat_ext(relative_path, __KAOS_PATH_SEPARATOR__);
         }
     }
@@ -106,15 +151,32 @@ char* resolveModulePath(char *module_name, bool directly_import, char *parent_co
         strcpy(module, "");
     }
 
-    module_path = strcat_ext(module_path, ".");
-    module_path = strcat_ext(module_path, __KAOS_LANGUAGE_FILE_EXTENSION__);
     relative_path = strcat_ext(relative_path, ".");
     relative_path = strcat_ext(relative_path, __KAOS_LANGUAGE_FILE_EXTENSION__);
 
     char *context = malloc(strlen(parent_context) + 1);
     strcpy(context, parent_context);
 
-    module_path = searchSpellsIfNotExits(module_path, relative_path);
+    // Importing the same module from the same context again does not touch the filesystem
+    ModuleResolution* resolution = findModuleResolution(parent_context, relative_path);
+    if (resolution == NULL) {
+        module_path = malloc(strlen(parent_context) + 1);
+        strcpy(module_path, parent_context);
+        if (strchr(module_path, __KAOS_PATH_SEPARATOR_ASCII__) == NULL) {
+            free(module_path);
+            module_path = "";
+        } else {
+            stripLastPathSegment(module_path);
+            module_path = strcat_ext(module_path, __KAOS_PATH_SEPARATOR__);
+        }
+        module_path = strcat_ext(module_path, relative_path);
+
+        module_path = searchSpellsIfNotExits(module_path, relative_path);
+        resolution = cacheModuleResolution(parent_context, relative_path, module_path);
+    } else {
+        module_path = strdup(resolution->module_path);
+    }
+    *kind = resolution->kind;
 
     _ast_root->files[_ast_root->file_count - 1]->module = module;
     _ast_root->files[_ast_root->file_count - 1]->module_path = module_path;
@@ -219,27 +281,32 @@ char* searchSpellsIfNotExits(char* module_path, char* relative_path) {
         return module_path;
     } else {
         free(module_path);
-        char* spells_dir = getMainModuleDir();
-        if (strlen(spells_dir) > 0) spells_dir = strcat_ext(spells_dir, __KAOS_PATH_SEPARATOR__);
         char* spell_name = remove_ext(relative_path, '.', __KAOS_PATH_SEPARATOR_ASCII__);
-        spells_dir = strcat_ext(spells_dir, __KAOS_SPELLS__);
-        spells_dir = strcat_ext(spells_dir, __KAOS_PATH_SEPARATOR__);
-        module_path = strcat_ext(spells_dir, spell_name);
-        free(spell_name);
-        module_path = strcat_ext(module_path, __KAOS_PATH_SEPARATOR__);
-        module_path = strcat_ext(module_path, relative_path);
-        module_path = relative_path_to_absolute(module_path);
-        if (is_file_exists(module_path)) {
-            return module_path;
+        // The candidates under the spells directory are not checked unless the spell is there
+        if (!isSpellInstalled(spell_name)) {
+            free(spell_name);
         } else {
-            char* dynamic_library_path = remove_ext(module_path, '.', __KAOS_PATH_SEPARATOR_ASCII__);
-            free(module_path);
-            dynamic_library_path = strcat_ext(dynamic_library_path, ".");
-            dynamic_library_path = strcat_ext(dynamic_library_path, __KAOS_DYNAMIC_LIBRARY_EXTENSION__);
-            if (is_file_exists(dynamic_library_path)) {
-                return dynamic_library_path;
+            char* spells_dir = getMainModuleDir();
+            if (strlen(spells_dir) > 0) spells_dir = strcat_ext(spells_dir, __KAOS_PATH_SEPARATOR__);
+            spells_dir = strcat_ext(spells_dir, __KAOS_SPELLS__);
+            spells_dir = strcat_ext(spells_dir, __KAOS_PATH_SEPARATOR__);
+            module_path = strcat_ext(spells_dir, spell_name);
+            free(spell_name);
+            module_path = strcat_ext(module_path, __KAOS_PATH_SEPARATOR__);
+            module_path = strcat_ext(module_path, relative_path);
+            module_path = relative_path_to_absolute(module_path);
+            if (is_file_exists(module_path)) {
+                return module_path;
             } else {
-                free(dynamic_library_path);
+                char* dynamic_library_path = remove_ext(module_path, '.', __KAOS_PATH_SEPARATOR_ASCII__);
+                free(module_path);
+                dynamic_library_path = strcat_ext(dynamic_library_path, ".");
+                dynamic_library_path = strcat_ext(dynamic_library_path, __KAOS_DYNAMIC_LIBRARY_EXTENSION__);
+                if (is_file_exists(dynamic_library_path)) {
+                    return dynamic_library_path;
+                } else {
+                    free(dynamic_library_path);
+                }
             }
         }
     }
@@ -247,3 +314,79 @@ char* searchSpellsIfNotExits(char* module_path, char* relative_path) {
     throw_error(E_MODULE_IS_EMPTY_OR_NOT_EXISTS_ON_PATH, relative_path);
     return NULL;
 }
+
+static void scanSpellsDirectory() {
+    spells_index.scanned = true;
+    spells_index.names.capacity = 0;
+    spells_index.names.size = 0;
+
+    char* spells_dir = getMainModuleDir();
+    if (strlen(spells_dir) > 0) spells_dir = strcat_ext(spells_dir, __KAOS_PATH_SEPARATOR__);
+    spells_dir = strcat_ext(spells_dir, __KAOS_SPELLS__);
+
+#if defined(_WIN32) || defined(_WIN64) || defined(__CYGWIN__)
+    spells_dir = strcat_ext(spells_dir, __KAOS_PATH_SEPARATOR__);
+    spells_dir = strcat_ext(spells_dir, "*");
+    WIN32_FIND_DATA FindFileData;
+    HANDLE handle = FindFirstFile(spells_dir, &FindFileData);
+    if (handle != INVALID_HANDLE_VALUE) {
+        do {
+            if (FindFileData.cFileName[0] != '.')
+                append_to_array(&spells_index.names, FindFileData.cFileName);
+        } while (FindNextFile(handle, &FindFileData));
+        FindClose(handle);
+    }
+#else
+    DIR* dir = opendir(spells_dir);
+    if (dir != NULL) {
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != NULL) {
+            if (entry->d_name[0] != '.')
+                append_to_array(&spells_index.names, entry->d_name);
+        }
+        closedir(dir);
+    }
+#endif
+
+    free(spells_dir);
+}
+
+bool isSpellInstalled(char* spell_name) {
+    if (!spells_index.scanned)
+        scanSpellsDirectory();
+
+    // A spell is installed if its top-level directory is in the spells directory
+    size_t length = strcspn(spell_name, __KAOS_PATH_SEPARATOR__);
+    for (unsigned i = 0; i < spells_index.names.size; i++) {
+        char* name = spells_index.names.arr[i];
+        if (strlen(name) == length && strncmp(name, spell_name, length) == 0)
+            return true;
+    }
+    return false;
+}
+
+void freeModuleResolutionCache() {
+    for (unsigned long i = 0; i < module_resolution_cache.capacity; i++) {
+        ModuleResolution* resolution = module_resolution_cache.buckets[i];
+        while (resolution != NULL) {
+            ModuleResolution* next = resolution->next;
+            free(resolution->parent_context);
+            free(resolution->selector);
+            free(resolution->module_path);
+            free(resolution);
+            resolution = next;
+        }
+    }
+    free(module_resolution_cache.buckets);
+    module_resolution_cache.buckets = NULL;
+    module_resolution_cache.capacity = 0;
+    module_resolution_cache.size = 0;
+
+    for (unsigned i = 0; i < spells_index.names.size; i++) {
+        free(spells_index.names.arr[i]);
+    }
+    if (spells_index.names.size > 0) free(spells_index.names.arr);
+    spells_index.names.capacity = 0;
+    spells_index.names.size = 0;
+    spells_index.scanned = false;
+}
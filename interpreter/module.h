@@ -31,21 +31,51 @@
 #include "../utilities/helpers.h"
 #include "extension.h"
 
+#if !defined(_WIN32) && !defined(_WIN64) && !defined(__CYGWIN__)
+#   include <dirent.h>
+#endif
+
 string_array modules_buffer;
 
+enum ModuleKind { MODULE_KAOS, MODULE_DYNAMIC_LIBRARY };
+
+// An import resolved once, keyed by the parent context and the module selector
+typedef struct ModuleResolution {
+    char *parent_context;
+    char *selector;
+    unsigned long long hash;
+    char *module_path;
+    enum ModuleKind kind;
+    struct ModuleResolution* next;
+} ModuleResolution;
+
+typedef struct ModuleResolutionCache {
+    ModuleResolution** buckets;
+    unsigned long capacity;
+    unsigned long size;
+} ModuleResolutionCache;
+
+ModuleResolutionCache module_resolution_cache;
+
+// The entries of the spells directory, it's listed only once per process
+typedef struct SpellsIndex {
+    bool scanned;
+    string_array names;
+} SpellsIndex;
+
+SpellsIndex spells_index;
+
 extern char *program_file_path;
 extern char *program_file_dir;
-extern char *program_code;
+extern source_buffer program_source;
 string_array module_path_stack;
 string_array module_stack;
 
-extern unsigned short module_parsing;
-
 void initMainContext();
 void appendModuleToModuleBuffer(char *name);
 void prependModuleToModuleBuffer(char *name);
-void moduleImportParse(char *module_path);
-char* resolveModulePath(char *module_name, bool directly_import, char *parent_context);
+void moduleImportParse(char *module_path, enum ModuleKind kind);
+char* resolveModulePath(char *module_name, bool directly_import, char *parent_context, enum ModuleKind* kind);
 void moduleImportCleanUp(char *module_path);
 void freeModulesBuffer();
 void pushModuleStack(char *module_path, char *module);
@@ -57,5 +87,7 @@ char* getMainModuleDir();
 char* getParentDir(char* path);
 void stripLastPathSegment(char* path);
 char* searchSpellsIfNotExits(char* module_path, char* relative_path);
+bool isSpellInstalled(char* spell_name);
+void freeModuleResolutionCache();
 
 #endif
@@ -2,10 +2,140 @@
 
 File* handleModuleImport(char *module_name, bool directly_import, char *parent_context) {
     addFile();
-    char *module_path = resolveModulePath(module_name, directly_import, parent_context);
+    enum ModuleKind kind;
+    char *module_path = resolveModulePath(module_name, directly_import, parent_context, &kind);
     pushModuleStack(module_path, module_name);
-    moduleImportParse(module_path);
+    moduleImportParse(module_path, kind);
     popModuleStack(module_path, module_name);
     // moduleImportCleanUp(module_path);
     return _ast_root->files[_ast_root->file_count - 1];
 }
+
+void queueModuleParse(File* file) {
+    if (module_parse_queue.size == module_parse_queue.capacity) {
+        module_parse_queue.capacity = module_parse_queue.capacity == 0 ? 8 : module_parse_queue.capacity * 2;
+        module_parse_queue.jobs = realloc(
+            module_parse_queue.jobs,
+            module_parse_queue.capacity * sizeof(ModuleParseJob)
+        );
+    }
+
+    ModuleParseJob* job = &module_parse_queue.jobs[module_parse_queue.size++];
+    job->file = file;
+    job->context.error_message = NULL;
+    job->context.error_cause = NULL;
+    job->missing = false;
+}
+
+static void parseModuleJob(ModuleParseJob* job) {
+    source_buffer source;
+    if (!fileReadSource(job->file->module_path, &source)) {
+        job->missing = true;
+        return;
+    }
+
+    // A module that did not change since it was last parsed is rebuilt from the AST cache
+    ASTCacheKey key = astCacheKey(&source);
+    if (loadASTCache(job->file, key)) {
+        freeSource(&source);
+        return;
+    }
+
+    // Every module is parsed with a scanner of its own, the line numbers start over
+    initParseContext(&job->context, job->file);
+    job->context.defer_errors = true;
+    setParseContextSource(&job->context, source.arr, source.length);
+    parse(&job->context);
+    freeParseContext(&job->context);
+    freeSource(&source);
+
+    if (job->context.error_message == NULL)
+        saveASTCache(job->file, key);
+}
+
+#if !defined(_WIN32) && !defined(_WIN64) && !defined(__CYGWIN__)
+static void* moduleParseWorker(void* arg) {
+    ModuleParseQueue* queue = (ModuleParseQueue*)arg;
+
+    while (true) {
+        pthread_mutex_lock(&queue->mutex);
+        unsigned long i = queue->next++;
+        pthread_mutex_unlock(&queue->mutex);
+
+        if (i >= queue->size)
+            break;
+
+        parseModuleJob(&queue->jobs[i]);
+    }
+
+    return NULL;
+}
+#endif
+
+void parseQueuedModules() {
+    ModuleParseQueue* queue = &module_parse_queue;
+    if (queue->size == 0)
+        return;
+
+    queue->next = 0;
+    initASTCache();
+
+#if !defined(_WIN32) && !defined(_WIN64) && !defined(__CYGWIN__)
+    // The calling thread takes jobs too, the extra threads only help when there is more than one module
+    long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned long thread_count = cpu_count > 1 ? (unsigned long) cpu_count : 1;
+    if (thread_count > queue->size)
+        thread_count = queue->size;
+    if (thread_count > __KAOS_MODULE_PARSE_MAX_THREADS__)
+        thread_count = __KAOS_MODULE_PARSE_MAX_THREADS__;
+
+    pthread_t threads[__KAOS_MODULE_PARSE_MAX_THREADS__];
+    unsigned long started = 0;
+    pthread_mutex_init(&queue->mutex, NULL);
+    for (; started + 1 < thread_count; started++) {
+        if (pthread_create(&threads[started], NULL, moduleParseWorker, queue) != 0)
+            break;
+    }
+
+    moduleParseWorker(queue);
+
+    for (unsigned long i = 0; i < started; i++)
+        pthread_join(threads[i], NULL);
+    pthread_mutex_destroy(&queue->mutex);
+#else
+    for (unsigned long i = 0; i < queue->size; i++)
+        parseModuleJob(&queue->jobs[i]);
+#endif
+
+    // The errors are reported on this thread and in the import order
+    unsigned long size = queue->size;
+    queue->size = 0;
+    for (unsigned long i = 0; i < size; i++) {
+        ModuleParseJob* job = &queue->jobs[i];
+        if (!job->missing && job->context.error_message == NULL)
+            continue;
+
+        for (unsigned long j = i + 1; j < size; j++) {
+            free(queue->jobs[j].context.error_message);
+            free(queue->jobs[j].context.error_cause);
+            queue->jobs[j].context.error_message = NULL;
+            queue->jobs[j].context.error_cause = NULL;
+        }
+
+        if (job->missing) {
+            append_to_array_without_malloc(&free_string_stack, job->file->module_path);
+            throw_error(E_MODULE_IS_EMPTY_OR_NOT_EXISTS_ON_PATH, job->file->module_path);
+        }
+        throwSyntaxError(&job->context);
+
+        // Only the first error is reported, the interactive shell returns here after absorbing it
+        return;
+    }
+}
+
+void freeModuleParseQueue() {
+    free(module_parse_queue.jobs);
+    module_parse_queue.jobs = NULL;
+    module_parse_queue.size = 0;
+    module_parse_queue.capacity = 0;
+}
@@ -3,7 +3,39 @@
 
 #include "module.h"
 #include "../ast/ast.h"
+#include "../ast/ast_cache.h"
+
+#if !defined(_WIN32) && !defined(_WIN64) && !defined(__CYGWIN__)
+#   include <pthread.h>
+#   include <unistd.h>
+#endif
+
+// Can be set at build time, -D__KAOS_MODULE_PARSE_MAX_THREADS__=1 parses the modules one after the other
+#ifndef __KAOS_MODULE_PARSE_MAX_THREADS__
+#   define __KAOS_MODULE_PARSE_MAX_THREADS__ 16
+#endif
+
+typedef struct ModuleParseJob {
+    File* file;
+    ParseContext context;
+    bool missing;
+} ModuleParseJob;
+
+typedef struct ModuleParseQueue {
+    ModuleParseJob* jobs;
+    unsigned long size;
+    unsigned long capacity;
+    unsigned long next;
+#if !defined(_WIN32) && !defined(_WIN64) && !defined(__CYGWIN__)
+    pthread_mutex_t mutex;
+#endif
+} ModuleParseQueue;
+
+ModuleParseQueue module_parse_queue;
 
 File* handleModuleImport(char *module_name, bool directly_import, char *parent_context);
+void queueModuleParse(File* file);
+void parseQueuedModules();
+void freeModuleParseQueue();
 
 #endif
@@ -48,10 +48,22 @@ char *value_type_names[] = {
 unsigned long long symbol_id_counter = 0;
 bool disable_complex_mode = false;
 
+static void indexSymbolById(Symbol* symbol) {
+    symbol->id = symbol_id_counter++;
+
+    if (symbol->id >= symbols_by_id.capacity) {
+        unsigned long long capacity = symbols_by_id.capacity == 0 ? 64 : symbols_by_id.capacity * 2;
+        symbols_by_id.arr = realloc(symbols_by_id.arr, capacity * sizeof(Symbol*));
+        memset(symbols_by_id.arr + symbols_by_id.capacity, 0, (capacity - symbols_by_id.capacity) * sizeof(Symbol*));
+        symbols_by_id.capacity = capacity;
+    }
+    symbols_by_id.arr[symbol->id] = symbol;
+}
+
 Symbol* addSymbol(char *name, enum Type type, union Value value, enum ValueType value_type) {
     Symbol* symbol;
     symbol = (struct Symbol*)calloc(1, sizeof(Symbol));
-    symbol->id = symbol_id_counter++;
+    indexSymbolById(symbol);
 
     if (isComplexMode() && complex_mode_stack.arr[complex_mode_stack.size - 1]->type == K_DICT) {
         if (name != NULL) {
@@ -60,16 +72,12 @@ Symbol* addSymbol(char *name, enum Type type, union Value value, enum ValueType
         }
     } else {
         if (isDefined(name)) {
-            free(symbol);
+            freeSymbol(symbol);
             if (type == K_STRING) {
                 free(value.s);
             }
             throw_error(E_VARIABLE_ALREADY_DEFINED, name);
         }
-        if (name != NULL) {
-            symbol->name = malloc(1 + strlen(name));
-            strcpy(symbol->name, name);
-        }
     }
 
     symbol->type = type;
@@ -79,6 +87,8 @@ Symbol* addSymbol(char *name, enum Type type, union Value value, enum ValueType
     symbol->role = DEFAULT;
 
     updateSymbolScope(symbol);
+    if (symbol->key == NULL && name != NULL)
+        setSymbolName(symbol, name);
 
     addSymbolToComplex(symbol);
 #if !defined(_WIN32) && !defined(_WIN64) && !defined(__CYGWIN__) && !defined(CHAOS_COMPILER)
@@ -89,7 +99,13 @@ Symbol* addSymbol(char *name, enum Type type, union Value value, enum ValueType
 }
 
 void updateSymbolScope(Symbol* symbol) {
-    symbol->scope = isComplexMode() ? scopeless : getCurrentScope();
+    linkSymbolToScope(symbol, isComplexMode() ? scopeless : getCurrentScope());
+}
+
+void linkSymbolToScope(Symbol* symbol, FunctionCall* scope) {
+    unmapSymbol(symbol);
+    symbol->scope = scope;
+    mapSymbol(symbol);
 
     if (symbol->scope->start_symbol == NULL) {
         symbol->scope->start_symbol = symbol;
@@ -102,6 +118,21 @@ void updateSymbolScope(Symbol* symbol) {
     }
 }
 
+Symbol* createSymbolInScope(FunctionCall* scope, char *key, enum Type type, union Value value, enum ValueType value_type) {
+    // Unlike addSymbol, the key is not copied and the symbol is not added to a complex
+    Symbol* symbol;
+    symbol = (struct Symbol*)calloc(1, sizeof(Symbol));
+    indexSymbolById(symbol);
+    symbol->key = key;
+    symbol->type = type;
+    symbol->value = value;
+    symbol->value_type = value_type;
+    symbol->children_count = 0;
+    symbol->role = DEFAULT;
+    linkSymbolToScope(symbol, scope);
+    return symbol;
+}
+
 Symbol* updateSymbol(char *name, enum Type type, union Value value, enum ValueType value_type) {
     Symbol* symbol = getSymbol(name);
 
@@ -124,6 +155,7 @@ void removeSymbolByName(char *name) {
 
 void removeSymbol(Symbol* symbol) {
     removeChildrenOfComplex(symbol);
+    unmapSymbol(symbol);
 
     Symbol* previous_symbol = symbol->previous;
     Symbol* next_symbol = symbol->next;
@@ -149,29 +181,109 @@ void removeSymbol(Symbol* symbol) {
 
 void freeSymbol(Symbol* symbol) {
     // if (symbol->value_type == V_STRING) free(symbol->value.s);
+    if (symbol->id < symbols_by_id.capacity)
+        symbols_by_id.arr[symbol->id] = NULL;
     if (symbol->children_count > 0) free(symbol->children);
     free(symbol->key);
-    free(symbol->name);
     free(symbol->secondary_name);
     free(symbol);
 }
 
-Symbol* findSymbol(char *name) {
-    FunctionCall* scope = getCurrentScope();
-    symbol_cursor = scope->start_symbol;
-    while (symbol_cursor != NULL) {
-        if (
-            symbol_cursor->name != NULL &&
-            strcmp(symbol_cursor->name, name) == 0
-        ) {
-            Symbol* symbol = symbol_cursor;
-            return symbol;
+void setSymbolName(Symbol* symbol, char *name) {
+    unmapSymbol(symbol);
+    symbol->name = intern_name(name, strlen(name));
+    symbol->name_hash = intern_name_hash(symbol->name);
+    mapSymbol(symbol);
+}
+
+void initSymbolMap(symbol_map* map) {
+    map->buckets = NULL;
+    map->capacity = 0;
+    map->size = 0;
+}
+
+void freeSymbolMap(symbol_map* map) {
+    free(map->buckets);
+    initSymbolMap(map);
+}
+
+static void appendToSymbolBucket(Symbol** bucket, Symbol* symbol) {
+    // Appending keeps the symbols with the same name in their definition order
+    symbol->hash_next = NULL;
+    while (*bucket != NULL)
+        bucket = &(*bucket)->hash_next;
+    *bucket = symbol;
+}
+
+static void growSymbolMap(symbol_map* map) {
+    unsigned long capacity = map->capacity == 0 ? 16 : map->capacity * 2;
+    Symbol** buckets = calloc(capacity, sizeof(Symbol*));
+
+    for (unsigned long i = 0; i < map->capacity; i++) {
+        Symbol* symbol = map->buckets[i];
+        while (symbol != NULL) {
+            Symbol* next = symbol->hash_next;
+            appendToSymbolBucket(&buckets[symbol->name_hash & (capacity - 1)], symbol);
+            symbol = next;
         }
-        symbol_cursor = symbol_cursor->next;
+    }
+
+    free(map->buckets);
+    map->buckets = buckets;
+    map->capacity = capacity;
+}
+
+void mapSymbol(Symbol* symbol) {
+    if (symbol->name == NULL || symbol->scope == NULL)
+        return;
+
+    symbol_map* map = &symbol->scope->symbols;
+    if (map->size >= map->capacity)
+        growSymbolMap(map);
+
+    appendToSymbolBucket(&map->buckets[symbol->name_hash & (map->capacity - 1)], symbol);
+    map->size++;
+}
+
+void unmapSymbol(Symbol* symbol) {
+    if (symbol->name == NULL || symbol->scope == NULL)
+        return;
+
+    symbol_map* map = &symbol->scope->symbols;
+    if (map->capacity == 0)
+        return;
+
+    Symbol** bucket = &map->buckets[symbol->name_hash & (map->capacity - 1)];
+    while (*bucket != NULL) {
+        if (*bucket == symbol) {
+            *bucket = symbol->hash_next;
+            symbol->hash_next = NULL;
+            map->size--;
+            return;
+        }
+        bucket = &(*bucket)->hash_next;
+    }
+}
+
+Symbol* findSymbolInScope(FunctionCall* scope, char *name) {
+    symbol_map* map = &scope->symbols;
+    if (name == NULL || map->size == 0)
+        return NULL;
+
+    unsigned long long hash = intern_hash_bytes(name, strlen(name));
+    Symbol* symbol = map->buckets[hash & (map->capacity - 1)];
+    while (symbol != NULL) {
+        if (symbol->name_hash == hash && (symbol->name == name || strcmp(symbol->name, name) == 0))
+            return symbol;
+        symbol = symbol->hash_next;
     }
     return NULL;
 }
 
+Symbol* findSymbol(char *name) {
+    return findSymbolInScope(getCurrentScope(), name);
+}
+
 Symbol* getSymbol(char *name) {
     Symbol* symbol = findSymbol(name);
     if (symbol != NULL)
@@ -181,14 +293,10 @@ Symbol* getSymbol(char *name) {
 }
 
 Symbol* getSymbolById(unsigned long long id) {
-    FunctionCall* scope = getCurrentScope();
-    symbol_cursor = scope->start_symbol;
-    while (symbol_cursor != NULL) {
-        if (symbol_cursor->id == id) {
-            Symbol* symbol = symbol_cursor;
+    if (id < symbols_by_id.capacity) {
+        Symbol* symbol = symbols_by_id.arr[id];
+        if (symbol != NULL && symbol->scope == getCurrentScope())
             return symbol;
-        }
-        symbol_cursor = symbol_cursor->next;
     }
     throw_error(E_NO_VARIABLE_WITH_ID, NULL, NULL, 0, id);
     return NULL;
@@ -367,167 +475,185 @@ long long getSymbolValueInt_ZeroIfNotInt(Symbol* symbol) {
 }
 
 void printSymbolValue(Symbol* symbol, bool is_complex, bool pretty, bool escaped, unsigned long iter) {
-    char *encoded = NULL;
-    encoded = encodeSymbolValueToString(symbol, is_complex, pretty, escaped, iter, encoded, false);
-    printf("%s", encoded);
-    free(encoded);
+    streamSymbolValue(symbol, is_complex, pretty, escaped, iter, false);
 }
 
 char* encodeSymbolValueToString(Symbol* symbol, bool is_complex, bool pretty, bool escaped, unsigned long iter, char *encoded, bool double_quotes) {
+    // Encoding is printing into a string buffer
+    cpu_output_buffer* previous = cpu_output_redirect(new_cpu_output_string());
+    if (encoded != NULL) {
+        cpu_output_str(encoded);
+        if (encoded[0] != '\0')
+            free(encoded);
+    }
+    streamSymbolValue(symbol, is_complex, pretty, escaped, iter, double_quotes);
+    return cpu_output_release_string(cpu_output_redirect(previous));
+}
+
+void streamSymbolValue(Symbol* symbol, bool is_complex, bool pretty, bool escaped, unsigned long iter, bool double_quotes) {
+    // Nested lists and dictionaries are walked with an explicit stack instead of recursion
+    symbol_print_frame* stack = NULL;
+    unsigned long depth = 0;
+    unsigned long capacity = 0;
+    Symbol* container = NULL;
+    unsigned long i = 0;
+
+    for (;;) {
+        if (symbol != NULL) {
+            if (symbol->value_type != V_REF && (symbol->type == K_LIST || symbol->type == K_DICT)) {
+                if (container != NULL) {
+                    if (depth == capacity) {
+                        capacity = capacity == 0 ? 16 : capacity * 2;
+                        stack = realloc(stack, capacity * sizeof(symbol_print_frame));
+                    }
+                    stack[depth].symbol = container;
+                    stack[depth].i = i;
+                    depth++;
+                }
+                container = symbol;
+                i = 0;
+                iter++;
+                cpu_output_char(symbol->type == K_LIST ? '[' : '{');
+                if (pretty)
+                    cpu_output_char('\n');
+            } else {
+                streamSymbolScalar(symbol, is_complex, escaped, double_quotes);
+            }
+            symbol = NULL;
+        }
+
+        if (container == NULL)
+            break;
+
+        if (i < container->children_count) {
+            Symbol* child = container->children[i];
+            if (i != 0) {
+                if (pretty)
+                    cpu_output_write(",\n", 2);
+                else
+                    cpu_output_write(", ", 2);
+            }
+            if (pretty)
+                cpu_output_indent(iter);
+            if (container->type == K_DICT) {
+                if (double_quotes) {
+                    cpu_output_json_string(child->key, strlen(child->key));
+                } else {
+                    cpu_output_char('\'');
+                    cpu_output_str(child->key);
+                    cpu_output_char('\'');
+                }
+                cpu_output_write(": ", 2);
+            }
+            i++;
+            symbol = child;
+            is_complex = true;
+            continue;
+        }
+
+        // The container is done, close it and continue with its parent
+        if (pretty) {
+            cpu_output_char('\n');
+            cpu_output_indent(iter - 1);
+        }
+        cpu_output_char(container->type == K_LIST ? ']' : '}');
+        iter--;
+
+        if (depth == 0)
+            break;
+        depth--;
+        container = stack[depth].symbol;
+        i = stack[depth].i;
+    }
+
+    free(stack);
+}
+
+void streamSymbolScalar(Symbol* symbol, bool is_complex, bool escaped, bool double_quotes) {
     if (symbol->value_type == V_REF) {
-        encoded = strcat_ext(encoded, "(ref)");
-        return encoded;
+        cpu_output_str("(ref)");
+        return;
     }
     switch (symbol->type) {
     case K_BOOL:
         switch (symbol->value_type) {
         case V_BOOL:
-            encoded = strcat_ext(encoded, symbol->value.b ? "true" : "false");
+            cpu_output_str(symbol->value.b ? "true" : "false");
             break;
         case V_VOID:
-            encoded = strcat_ext(encoded, "N/A");
+            cpu_output_str("N/A");
             break;
         default:
             throw_error(E_UNEXPECTED_VALUE_TYPE, symbol->name, NULL, 0, symbol->value_type);
             break;
         }
-        return encoded;
+        break;
     case K_NUMBER:
         switch (symbol->value_type) {
         case V_INT:
-            encoded = snprintf_concat_int(encoded, "%lld", symbol->value.i);
+            cpu_output_commit(cpu_format_int(symbol->value.i, cpu_output_reserve(CPU_FORMAT_MAX)));
             break;
         case V_FLOAT:
-            encoded = snprintf_concat_float(encoded, "%Lg", symbol->value.f);
+            cpu_output_commit(cpu_format_float(symbol->value.f, cpu_output_reserve(CPU_FORMAT_MAX)));
             break;
         case V_VOID:
-            encoded = strcat_ext(encoded, "N/A");
+            cpu_output_str("N/A");
             break;
         default:
             throw_error(E_UNEXPECTED_VALUE_TYPE, symbol->name, NULL, 0, symbol->value_type);
             break;
         }
-        return encoded;
+        break;
     case K_STRING:
         if (symbol->value_type == V_VOID || symbol->value.s == NULL) {
-            return strcat_ext(encoded, "N/A");
+            cpu_output_str("N/A");
+            break;
         }
-        if (is_complex) {
-            if (double_quotes) {
-                encoded = snprintf_concat_string(encoded, "\"%s\"", symbol->value.s);
-            } else {
-                encoded = snprintf_concat_string(encoded, "'%s'", symbol->value.s);
-            }
+        if (is_complex && double_quotes) {
+            cpu_output_json_string(symbol->value.s, strlen(symbol->value.s));
+        } else if (is_complex) {
+            cpu_output_char('\'');
+            cpu_output_str(symbol->value.s);
+            cpu_output_char('\'');
+        } else if (escaped) {
+            char* out = escape_the_sequences_in_string_literal(symbol->value.s);
+            cpu_output_str(out);
+            free(out);
         } else {
-            if (escaped) {
-                char* out = escape_the_sequences_in_string_literal(symbol->value.s);
-                encoded = strcat_ext(encoded, out);
-                free(out);
-            } else {
-                encoded = strcat_ext(encoded, symbol->value.s);
-            }
-        }
-        return encoded;
-    case K_LIST:
-        iter++;
-        encoded = strcat_ext(encoded, "[");
-        if (pretty) {
-            encoded = strcat_ext(encoded, "\n");
-        }
-        for (unsigned long i = 0; i < symbol->children_count; i++) {
-            if (pretty) {
-                for (unsigned long j = 0; j < iter; j++) {
-                    encoded = strcat_ext(encoded, __KAOS_TAB__);
-                }
-            }
-            encoded = encodeSymbolValueToString(symbol->children[i], true, pretty, escaped, iter, encoded, double_quotes);
-            if (i + 1 != symbol->children_count) {
-                if (pretty) {
-                    encoded = strcat_ext(encoded, ",\n");
-                } else {
-                    encoded = strcat_ext(encoded, ", ");
-                }
-            }
-        }
-        if (pretty) {
-            encoded = strcat_ext(encoded, "\n");
-        }
-        if (pretty) {
-            for (unsigned long j = 0; j < (iter - 1); j++) {
-                encoded = strcat_ext(encoded, __KAOS_TAB__);
-            }
-        }
-        encoded = strcat_ext(encoded, "]");
-        return encoded;
-    case K_DICT:
-        iter++;
-        encoded = strcat_ext(encoded, "{");
-        if (pretty) {
-            encoded = strcat_ext(encoded, "\n");
+            cpu_output_str(symbol->value.s);
         }
-        for (unsigned long i = 0; i < symbol->children_count; i++) {
-            if (pretty) {
-                for (unsigned long j = 0; j < iter; j++) {
-                    encoded = strcat_ext(encoded, __KAOS_TAB__);
-                }
-            }
-            Symbol* child = symbol->children[i];
-            if (double_quotes) {
-                encoded = snprintf_concat_string(encoded, "\"%s\": ", child->key);
-            } else {
-                encoded = snprintf_concat_string(encoded, "'%s': ", child->key);
-            }
-            encoded = encodeSymbolValueToString(child, true, pretty, escaped, iter, encoded, double_quotes);
-            if (i + 1 != symbol->children_count) {
-                if (pretty) {
-                    encoded = strcat_ext(encoded, ",\n");
-                } else {
-                    encoded = strcat_ext(encoded, ", ");
-                }
-            }
-        }
-        if (pretty) {
-            encoded = strcat_ext(encoded, "\n");
-        }
-        if (pretty) {
-            for (unsigned long j = 0; j < (iter - 1); j++) {
-                encoded = strcat_ext(encoded, __KAOS_TAB__);
-            }
-        }
-        encoded = strcat_ext(encoded, "}");
-        return encoded;
+        break;
     case K_ANY:
         switch (symbol->value_type) {
         case V_STRING:
-            encoded = strcat_ext(encoded, symbol->value.s);
+            cpu_output_str(symbol->value.s);
             break;
         case V_INT:
-            encoded = snprintf_concat_int(encoded, "%lld", symbol->value.i);
+            cpu_output_commit(cpu_format_int(symbol->value.i, cpu_output_reserve(CPU_FORMAT_MAX)));
             break;
         case V_FLOAT:
-            encoded = snprintf_concat_float(encoded, "%Lg", symbol->value.f);
+            cpu_output_commit(cpu_format_float(symbol->value.f, cpu_output_reserve(CPU_FORMAT_MAX)));
             break;
         case V_BOOL:
-            encoded = strcat_ext(encoded, symbol->value.b ? "true" : "false");
+            cpu_output_str(symbol->value.b ? "true" : "false");
             break;
         case V_VOID:
-            encoded = strcat_ext(encoded, "N/A");
+            cpu_output_str("N/A");
             break;
         default:
             throw_error(E_UNEXPECTED_VALUE_TYPE, symbol->name, NULL, 0, symbol->value_type);
             break;
         }
-        return encoded;
+        break;
     default:
         throw_error(E_UNKNOWN_VARIABLE_TYPE, getTypeName(symbol->type), symbol->name);
         break;
     }
-    return encoded;
 }
 
 void printSymbolValueEndWith(Symbol* symbol, char *end, bool pretty, bool escaped) {
     printSymbolValue(symbol, false, pretty, escaped, 0);
-    printf("%s", end);
+    cpu_output_str(end);
 }
 
 void printSymbolValueEndWithNewLine(Symbol* symbol, bool pretty, bool escaped) {
@@ -535,18 +661,7 @@ void printSymbolValueEndWithNewLine(Symbol* symbol, bool pretty, bool escaped) {
 }
 
 bool isDefined(char *name) {
-    FunctionCall* scope = getCurrentScope();
-    symbol_cursor = scope->start_symbol;
-    while (symbol_cursor != NULL) {
-        if (
-            symbol_cursor->name != NULL &&
-            name != NULL && strcmp(symbol_cursor->name, name) == 0
-        ) {
-            return true;
-        }
-        symbol_cursor = symbol_cursor->next;
-    }
-    return false;
+    return findSymbol(name) != NULL;
 }
 
 void addSymbolToComplex(Symbol* symbol) {
@@ -714,10 +829,8 @@ Symbol* createCloneFromSymbol(char *clone_name, enum Type type, Symbol* symbol,
         } else {
             clone_symbol = deepCopySymbol(symbol, symbol->type, NULL);
         }
-        if (clone_name != NULL) {
-            clone_symbol->name = malloc(1 + strlen(clone_name));
-            strcpy(clone_symbol->name, clone_name);
-        }
+        if (clone_name != NULL)
+            setSymbolName(clone_symbol, clone_name);
     }
     return clone_symbol;
 }
@@ -742,8 +855,7 @@ Symbol* updateSymbolByClonning(char *clone_name, Symbol* symbol) {
     } else {
         clone_symbol = deepCopySymbol(symbol, symbol->type, NULL);
     }
-    clone_symbol->name = malloc(1 + strlen(clone_name));
-    strcpy(clone_symbol->name, clone_name);
+    setSymbolName(clone_symbol, clone_name);
 
     removeSymbol(temp_symbol);
     return clone_symbol;
@@ -797,8 +909,7 @@ Symbol* finishComplexMode(char *name, enum Type type) {
             throw_error(E_VARIABLE_ALREADY_DEFINED, name);
         }
 
-        complex_mode->name = malloc(1 + strlen(name));
-        strcpy(complex_mode->name, name);
+        setSymbolName(complex_mode, name);
     }
     complex_mode->secondary_type = type;
     // enum Type illegal_type = isComplexIllegal(type);
@@ -1205,17 +1316,20 @@ Symbol* getSymbolFunctionParameter(char *name) {
 
 void freeAllSymbols() {
     for (unsigned i = 0; i < function_call_stack.size + 1; i++) {
-        if (i == 0)
-            symbol_cursor = scopeless->start_symbol;
-        else
-            symbol_cursor = function_call_stack.arr[i - 1]->start_symbol;
+        FunctionCall* scope = i == 0 ? scopeless : function_call_stack.arr[i - 1];
+        symbol_cursor = scope->start_symbol;
 
         while (symbol_cursor != NULL) {
             Symbol* symbol = symbol_cursor;
             symbol_cursor = symbol_cursor->next;
             freeSymbol(symbol);
         }
+        freeSymbolMap(&scope->symbols);
     }
+
+    free(symbols_by_id.arr);
+    symbols_by_id.arr = NULL;
+    symbols_by_id.capacity = 0;
 }
 
 Symbol* assignByTypeCasting(Symbol* clone_symbol, Symbol* symbol) {
@@ -1706,6 +1820,7 @@ bool resolveRelSmallEqualUnknown(char* name_l, char* name_r) {
 }
 
 void changeSymbolScope(Symbol* symbol, FunctionCall* scope) {
+    unmapSymbol(symbol);
     Symbol* previous_symbol = symbol->previous;
     Symbol* next_symbol = symbol->next;
 
@@ -1724,6 +1839,7 @@ void changeSymbolScope(Symbol* symbol, FunctionCall* scope) {
     }
 
     symbol->scope = scope;
+    mapSymbol(symbol);
 
     if (symbol->scope->start_symbol == NULL) {
         symbol->scope->start_symbol = symbol;
@@ -30,9 +30,18 @@
 
 typedef struct Symbol Symbol;
 
+// The named symbols of a scope, hashed into chains that keep the definition order
+typedef struct symbol_map {
+    Symbol** buckets;
+    unsigned long capacity;
+    unsigned long size;
+} symbol_map;
+
 #include "../enums.h"
 #include "errors.h"
 #include "../utilities/helpers.h"
+#include "../vm/format.h"
+#include "../vm/intern.h"
 
 #if !defined(_WIN32) && !defined(_WIN64) && !defined(__CYGWIN__)
 #   include "../utilities/shell.h"
@@ -65,16 +74,32 @@ typedef struct Symbol {
     struct _Function* param_of;
     long long addr;
     bool is_dynamic;
+    unsigned long long name_hash;
+    struct Symbol* hash_next;
 } Symbol;
 
 Symbol* symbol_cursor;
 
+// Every symbol by its id, the slots of the removed symbols are NULL
+typedef struct symbol_index {
+    Symbol** arr;
+    unsigned long long capacity;
+} symbol_index;
+
+symbol_index symbols_by_id;
+
 typedef struct symbol_array {
     Symbol** arr;
     unsigned long* child_counter;
     unsigned capacity, size;
 } symbol_array;
 
+// A list or dictionary being encoded and the position of its next child
+typedef struct symbol_print_frame {
+    Symbol* symbol;
+    unsigned long i;
+} symbol_print_frame;
+
 symbol_array complex_mode_stack;
 symbol_array nested_complex_mode_stack;
 
@@ -89,10 +114,18 @@ unsigned long long variable_complex_element_symbol_id;
 
 Symbol* addSymbol(char *name, enum Type type, union Value value, enum ValueType value_type);
 void updateSymbolScope(Symbol* symbol);
+void linkSymbolToScope(Symbol* symbol, FunctionCall* scope);
+Symbol* createSymbolInScope(FunctionCall* scope, char *key, enum Type type, union Value value, enum ValueType value_type);
 Symbol* updateSymbol(char *name, enum Type type, union Value value, enum ValueType value_type);
 void removeSymbolByName(char *name);
 void removeSymbol(Symbol* symbol);
 void freeSymbol(Symbol* symbol);
+void setSymbolName(Symbol* symbol, char *name);
+void initSymbolMap(symbol_map* map);
+void freeSymbolMap(symbol_map* map);
+void mapSymbol(Symbol* symbol);
+void unmapSymbol(Symbol* symbol);
+Symbol* findSymbolInScope(FunctionCall* scope, char *name);
 Symbol* findSymbol(char *name);
 Symbol* getSymbol(char *name);
 Symbol* getSymbolById(unsigned long long id);
@@ -112,6 +145,8 @@ void printSymbolValue(Symbol* symbol, bool is_complex, bool pretty, bool escaped
 void printSymbolValueEndWith(Symbol* symbol, char *end, bool pretty, bool escaped);
 void printSymbolValueEndWithNewLine(Symbol* symbol, bool pretty, bool escaped);
 char* encodeSymbolValueToString(Symbol* symbol, bool is_complex, bool pretty, bool escaped, unsigned long iter, char *encoded, bool double_quotes);
+void streamSymbolValue(Symbol* symbol, bool is_complex, bool pretty, bool escaped, unsigned long iter, bool double_quotes);
+void streamSymbolScalar(Symbol* symbol, bool is_complex, bool escaped, bool double_quotes);
 bool isDefined(char *name);
 void addSymbolToComplex(Symbol* symbol);
 void printSymbolTable();
@@ -30,16 +30,21 @@
 
 #include "../enums.h"
 
-extern bool inject_mode;
+typedef struct File File;
+typedef struct ParseContext ParseContext;
 
-void injectCode(char *code, enum Phase phase_arg);
-void switchBuffer(char *code, enum Phase phase_arg);
+void initParseContext(ParseContext* context, File* file);
+void setParseContextSource(ParseContext* context, char *code, size_t length);
+void setParseContextInput(ParseContext* context, FILE* input);
+int parse(ParseContext* context);
+void freeParseContext(ParseContext* context);
+void throwSyntaxError(ParseContext* context);
+
+int yyget_lineno(void* yyscanner);
+char *yyget_text(void* yyscanner);
 
 #ifndef CHAOS_COMPILER
-void yyrestart_interactive();
-void flushLexer();
+void yyrestart_interactive(ParseContext* context);
 #endif
 
-void parseTheModuleContent(char *module_path);
-
 #endif
@@ -126,6 +126,7 @@ int initParser(int argc, char** argv) {
     fp_opened = true;
 
     is_interactive = (fp != stdin) ? false : true;
+    init_cpu_output(is_interactive);
 
     if (!is_interactive) {
         program_file_path = malloc(strlen(program_file) + 1);
@@ -162,7 +163,9 @@ int initParser(int argc, char** argv) {
         program_file_path = strcat_ext(program_file_path, __KAOS_INTERACTIVE_MODULE_NAME__);
     }
 
-    yyin = fp;
+    initASTRoot();
+    initMainFunction();
+    initParseContext(&program_context, _ast_root->files[0]);
 
     if (is_interactive) {
 #   if !defined(_WIN32) && !defined(_WIN64) && !defined(__CYGWIN__)
@@ -170,22 +173,15 @@ int initParser(int argc, char** argv) {
         read_history(NULL);
 #   endif
         greet();
-        phase = INIT_PROGRAM;
+        setParseContextInput(&program_context, fp);
         interactive_program = initProgram();
         interactive_c = new_cpu(interactive_program, debug_level);
         initCallJumps();
     } else {
-        program_code = fileGetContents(program_file_path);
-        size_t program_length = strlen(program_code);
-        program_code = (char*)realloc(program_code, program_length + 2);
-        program_code[program_length] = '\n';
-        program_code[program_length + 1] = '\0';
-        switchBuffer(program_code, INIT_PROGRAM);
+        program_source = fileGetSource(program_file_path);
+        setParseContextSource(&program_context, program_source.arr, program_source.length);
     }
 
-    initASTRoot();
-    initMainFunction();
-
     main_interpreted_module = NULL;
     prev_stmt_count = 0;
     prev_import_count = 0;
@@ -201,7 +197,8 @@ int initParser(int argc, char** argv) {
 #   endif
         main_interpreted_module = malloc(1 + strlen(_ast_root->files[_ast_root->file_count - 1]->module_path));
         strcpy(main_interpreted_module, _ast_root->files[_ast_root->file_count - 1]->module_path);
-        yyparse();
+        phase = PROGRAM;
+        parse(&program_context);
 
         if (is_interactive)
             break;
@@ -229,6 +226,9 @@ int initParser(int argc, char** argv) {
         cpu *c = new_cpu(program, debug_level);
         run_cpu(c);
         free_cpu(c);
+
+        // The errors raised at runtime point into the AST, so it is released only after the run
+        freeASTFiles();
         // if (!is_interactive) {
         //     if (compiler_mode) {
         //         compile(main_interpreted_module, INIT_PREPARSE, bin_file, extra_flags, keep);
@@ -237,7 +237,7 @@ int initParser(int argc, char** argv) {
         //     }
         // }
         if (!is_interactive) break;
-    } while(!feof(yyin));
+    } while(!feof(fp));
 
     freeEverything();
 
@@ -320,19 +320,25 @@ void freeEverything() {
     free(function_names_buffer.arr);
     if (strlen(decision_buffer) > 0) free(decision_buffer);
     freeModulePathStack();
+    freeModuleParseQueue();
+    freeModuleResolutionCache();
+    freeASTCache();
     freeModuleStack();
     freeComplexModeStack();
     freeLeftRightBracketStack();
     freeFreeStringStack();
     freeNestedComplexModeStack();
+    free_intern_table();
+    free_name_table();
+    free_cpu_output();
     free(function_call_stack.arr);
     free(program_file_path);
 
 #ifndef CHAOS_COMPILER
-    yylex_destroy();
+    freeParseContext(&program_context);
 
     if (!is_interactive) {
-        free(program_code);
+        freeSource(&program_source);
         if (fp_opened)
             fclose(fp);
         free(program_file_dir);
@@ -354,12 +360,26 @@ void freeEverything() {
 #endif
 }
 
-void yyerror(const char* s) {
-    if (phase == PREPARSE) return;
+void yyerror(void* scanner, ParseContext* context, const char* s) {
+    if (context->phase == PREPARSE) return;
+
+    context->error_message = capitalize(s);
+    context->error_cause = strdup(yyget_text(scanner));
+    context->error_lineno = yyget_lineno(scanner);
+
+    // The modules that are parsed in parallel report their errors once all of them are parsed
+    if (context->defer_errors)
+        return;
+
+    throwSyntaxError(context);
+}
 
-    char *error_name = capitalize(s);
-    yyerror_msg(error_name, getCurrentModule(), yytext);
-    free(error_name);
+void throwSyntaxError(ParseContext* context) {
+    yyerror_msg(context->error_message, context->file->module_path, context->error_lineno, context->error_cause);
+    free(context->error_message);
+    free(context->error_cause);
+    context->error_message = NULL;
+    context->error_cause = NULL;
 
 #ifndef CHAOS_COMPILER
     if (is_interactive) {
@@ -370,12 +390,12 @@ void yyerror(const char* s) {
 #   if defined(_WIN32) || defined(_WIN64) || defined(__CYGWIN__)
         printf("%s ", __KAOS_SHELL_INDICATOR__);
 #   endif
-        flushLexer();
-        phase = INIT_PROGRAM;
-        yyrestart_interactive();
+        program_context.phase = INIT_PROGRAM;
+        yyrestart_interactive(&program_context);
         freeModulePathStack();
         initMainContext();
-        yyparse();
+        phase = PROGRAM;
+        parse(&program_context);
     } else {
 #endif
         freeEverything();
@@ -388,6 +408,8 @@ void yyerror(const char* s) {
 #ifndef CHAOS_COMPILER
 void absorbError() {
     phase = INIT_PROGRAM;
+    program_context.phase = INIT_PROGRAM;
+    parse_context = NULL;
     disable_complex_mode = false;
     freeComplexModeStack();
     freeLeftRightBracketStackSymbols();
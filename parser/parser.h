@@ -38,12 +38,9 @@
 #endif
 
 #include "../ast/ast_print.h"
+#include "../lexer/lexer.h"
 #include "../vm/cpu.h"
 
-extern int yyparse();
-extern int yylex_destroy();
-extern FILE* yyin;
-extern char *yytext;
 FILE *fp;
 bool fp_opened;
 
@@ -54,7 +51,8 @@ FILE* tmp_stdin;
 
 char *program_file_path;
 char *program_file_dir;
-char *program_code;
+source_buffer program_source;
+ParseContext program_context;
 char *main_interpreted_module;
 jmp_buf InteractiveShellErrorAbsorber;
 
@@ -67,7 +65,7 @@ bool compiling_a_function;
 int initParser(int argc, char** argv);
 void compile_interactive();
 void freeEverything();
-void yyerror(const char* s);
+void yyerror(void* scanner, ParseContext* context, const char* s);
 
 #ifndef CHAOS_COMPILER
 void absorbError();
@@ -29,25 +29,23 @@
 
 #include "parser/parser.h"
 
-extern int yylex();
-extern int yyparse();
-extern int yylex_destroy();
-extern FILE* yyin;
-
-extern int yylineno;
-extern char *yytext;
-
 #ifndef CHAOS_COMPILER
 extern bool is_interactive;
 #endif
 
-bool inject_mode = false;
 bool interactively_importing = false;
 
 extern char *main_interpreted_module;
-extern unsigned long long shell_indicator_block_counter;
 %}
 
+%define api.pure full
+%param {void* scanner}
+%parse-param {ParseContext* context}
+
+%code {
+int yylex(YYSTYPE* yylval_param, void* yyscanner);
+}
+
 %union {
     bool bval;
     long long ival;
@@ -63,7 +61,7 @@ extern unsigned long long shell_indicator_block_counter;
     FuncDeclCom* func_decl_com;
 }
 
-%token START_PROGRAM START_PREPARSE START_JSON_PARSE
+%token START_PROGRAM START_PREPARSE
 %token<bval> T_TRUE T_FALSE
 %token<ival> T_INT T_TIMES_DO_INT
 %token<fval> T_FLOAT
@@ -86,7 +84,7 @@ extern unsigned long long shell_indicator_block_counter;
 %right T_U_ADD T_U_SUB T_U_NOT T_U_TILDE
 
 %type<expr> expr basic_lit ident binary_expr bool_expr unary_expr paren_expr incdec_expr
-%type<expr> index_expr composite_lit key_value_expr
+%type<expr> index_expr slice_expr composite_lit key_value_expr
 %type<expr> module_selector alias_expr
 %type<expr> selector_expr call_expr decision_expr default_expr
 %type<stmt> stmt assign_stmt print_stmt echo_stmt return_stmt expr_stmt decl_stmt del_stmt exit_stmt
@@ -99,10 +97,7 @@ extern unsigned long long shell_indicator_block_counter;
 %type<expr_list> alias_expr_list expr_list key_value_list decision_expr_list
 %type<stmt_list> stmt_list
 %type<func_decl_com> func_type
-
-%destructor {
-    free($$);
-} <sval>
+%type<ival> import_keyword from_keyword
 
 %start meta_start
 
@@ -114,10 +109,10 @@ meta_start:
 
 parser:
     | parser line {
-        if (is_interactive) {
+        if (is_interactive && context == &program_context) {
             compile_interactive();
 #   if defined(_WIN32) || defined(_WIN64) || defined(__CYGWIN__)
-            if (shell_indicator_block_counter > 0) {
+            if (context->shell_indicator_block_counter > 0) {
                 printf("%s ", __KAOS_SHELL_INDICATOR_BLOCK__);
             } else {
                 printf("%s ", __KAOS_SHELL_INDICATOR__);
@@ -129,18 +124,10 @@ parser:
 
 line: T_NEWLINE
     | import {
-        File* file = _ast_root->files[_ast_root->file_count - 1];
-        if (is_interactive && !interactively_importing)
-            file = _ast_root->files[0];
-
-        addSpec(file->imports, $1);
+        addSpec(context->file->imports, $1);
     }
     | stmt {
-        File* file = _ast_root->files[_ast_root->file_count - 1];
-        if (is_interactive && !interactively_importing)
-            file = _ast_root->files[0];
-
-        addStmtLine(file->stmt_list, $1);
+        addStmtLine(context->file->stmt_list, $1);
     }
 ;
 
@@ -166,6 +153,9 @@ expr:
     | index_expr {
         $$ = $1;
     }
+    | slice_expr {
+        $$ = $1;
+    }
     | composite_lit {
         $$ = $1;
     }
@@ -176,58 +166,58 @@ expr:
 
 ident:
     T_VAR {
-        $$ = ident($1, yylineno);
+        $$ = ident($1, yyget_lineno(scanner));
     }
 ;
 
 basic_lit:
     T_TRUE {
-        $$ = basicLitBool($1, yylineno);
+        $$ = basicLitBool($1, yyget_lineno(scanner));
     }
     | T_FALSE {
-        $$ = basicLitBool($1, yylineno);
+        $$ = basicLitBool($1, yyget_lineno(scanner));
     }
     | T_INT {
-        $$ = basicLitInt($1, yylineno);
+        $$ = basicLitInt($1, yyget_lineno(scanner));
     }
     | T_FLOAT {
-        $$ = basicLitFloat($1, yylineno);
+        $$ = basicLitFloat($1, yyget_lineno(scanner));
     }
     | T_STRING {
-        $$ = basicLitString($1, yylineno);
+        $$ = basicLitString($1, yyget_lineno(scanner));
     }
 ;
 
 binary_expr:
     expr T_ADD expr {
-        $$ = binaryExpr($1, ADD_tok, $3, yylineno);
+        $$ = binaryExpr($1, ADD_tok, $3, yyget_lineno(scanner));
     }
     | expr T_SUB expr {
-        $$ = binaryExpr($1, SUB_tok, $3, yylineno);
+        $$ = binaryExpr($1, SUB_tok, $3, yyget_lineno(scanner));
     }
     | expr T_MUL expr {
-        $$ = binaryExpr($1, MUL_tok, $3, yylineno);
+        $$ = binaryExpr($1, MUL_tok, $3, yyget_lineno(scanner));
     }
     | expr T_QUO expr {
-        $$ = binaryExpr($1, QUO_tok, $3, yylineno);
+        $$ = binaryExpr($1, QUO_tok, $3, yyget_lineno(scanner));
     }
     | expr T_REM expr {
-        $$ = binaryExpr($1, REM_tok, $3, yylineno);
+        $$ = binaryExpr($1, REM_tok, $3, yyget_lineno(scanner));
     }
     | expr T_AND expr {
-        $$ = binaryExpr($1, AND_tok, $3, yylineno);
+        $$ = binaryExpr($1, AND_tok, $3, yyget_lineno(scanner));
     }
     | expr T_OR expr {
-        $$ = binaryExpr($1, OR_tok, $3, yylineno);
+        $$ = binaryExpr($1, OR_tok, $3, yyget_lineno(scanner));
     }
     | expr T_XOR expr {
-        $$ = binaryExpr($1, XOR_tok, $3, yylineno);
+        $$ = binaryExpr($1, XOR_tok, $3, yyget_lineno(scanner));
     }
     | expr T_SHL expr {
-        $$ = binaryExpr($1, SHL_tok, $3, yylineno);
+        $$ = binaryExpr($1, SHL_tok, $3, yyget_lineno(scanner));
     }
     | expr T_SHR expr {
-        $$ = binaryExpr($1, SHR_tok, $3, yylineno);
+        $$ = binaryExpr($1, SHR_tok, $3, yyget_lineno(scanner));
     }
     | bool_expr {
         $$ = $1;
@@ -236,79 +226,79 @@ binary_expr:
 
 bool_expr:
     expr T_EQL expr {
-        $$ = binaryExpr($1, EQL_tok, $3, yylineno);
+        $$ = binaryExpr($1, EQL_tok, $3, yyget_lineno(scanner));
     }
     | expr T_NEQ expr {
-        $$ = binaryExpr($1, NEQ_tok, $3, yylineno);
+        $$ = binaryExpr($1, NEQ_tok, $3, yyget_lineno(scanner));
     }
     | expr T_GTR expr {
-        $$ = binaryExpr($1, GTR_tok, $3, yylineno);
+        $$ = binaryExpr($1, GTR_tok, $3, yyget_lineno(scanner));
     }
     | expr T_LSS expr {
-        $$ = binaryExpr($1, LSS_tok, $3, yylineno);
+        $$ = binaryExpr($1, LSS_tok, $3, yyget_lineno(scanner));
     }
     | expr T_GEQ expr {
-        $$ = binaryExpr($1, GEQ_tok, $3, yylineno);
+        $$ = binaryExpr($1, GEQ_tok, $3, yyget_lineno(scanner));
     }
     | expr T_LEQ expr {
-        $$ = binaryExpr($1, LEQ_tok, $3, yylineno);
+        $$ = binaryExpr($1, LEQ_tok, $3, yyget_lineno(scanner));
     }
     | expr T_LAND expr {
-        $$ = binaryExpr($1, LAND_tok, $3, yylineno);
+        $$ = binaryExpr($1, LAND_tok, $3, yyget_lineno(scanner));
     }
     | expr T_LOR expr {
-        $$ = binaryExpr($1, LOR_tok, $3, yylineno);
+        $$ = binaryExpr($1, LOR_tok, $3, yyget_lineno(scanner));
     }
 ;
 
 unary_expr:
     T_ADD expr %prec T_U_ADD {
-        $$ = unaryExpr(ADD_tok, $2, yylineno);
+        $$ = unaryExpr(ADD_tok, $2, yyget_lineno(scanner));
     }
     | T_SUB expr %prec T_U_SUB {
-        $$ = unaryExpr(SUB_tok, $2, yylineno);
+        $$ = unaryExpr(SUB_tok, $2, yyget_lineno(scanner));
     }
     | T_NOT expr %prec T_U_NOT {
-        $$ = unaryExpr(NOT_tok, $2, yylineno);
+        $$ = unaryExpr(NOT_tok, $2, yyget_lineno(scanner));
     }
     | T_TILDE expr %prec T_U_TILDE {
-        $$ = unaryExpr(TILDE_tok, $2, yylineno);
+        $$ = unaryExpr(TILDE_tok, $2, yyget_lineno(scanner));
     }
 ;
 
 paren_expr:
     T_LPAREN expr T_RPAREN {
-        $$ = parenExpr($2, yylineno);
+        $$ = parenExpr($2, yyget_lineno(scanner));
     }
 ;
 
 incdec_expr:
     T_INC expr {
-        $$ = incDecExpr(INC_tok, $2, true, yylineno);
+        $$ = incDecExpr(INC_tok, $2, true, yyget_lineno(scanner));
     }
     | expr T_INC {
-        $$ = incDecExpr(INC_tok, $1, false, yylineno);
+        $$ = incDecExpr(INC_tok, $1, false, yyget_lineno(scanner));
     }
     | T_DEC expr {
-        $$ = incDecExpr(DEC_tok, $2, true, yylineno);
+        $$ = incDecExpr(DEC_tok, $2, true, yyget_lineno(scanner));
     }
     | expr T_DEC {
-        $$ = incDecExpr(DEC_tok, $1, false, yylineno);
+        $$ = incDecExpr(DEC_tok, $1, false, yyget_lineno(scanner));
     }
 ;
 
 alias_expr:
     ident {
-        $$ = aliasExpr($1, NULL, yylineno);
+        $$ = aliasExpr($1, NULL, yyget_lineno(scanner));
     }
     | ident T_AS ident {
-        $$ = aliasExpr($1, $3, yylineno);
+        $$ = aliasExpr($1, $3, yyget_lineno(scanner));
     }
 ;
 
 alias_expr_list:
     alias_expr {
-        $$ = (struct ExprList*)calloc(1, sizeof(ExprList));
+        $$ = (struct ExprList*)astAlloc(sizeof(ExprList));
         $$->expr_count = 0;
         addExpr($$, $1);
     }
@@ -320,13 +310,25 @@ alias_expr_list:
 
 index_expr:
     expr T_LBRACK expr T_RBRACK {
-        $$ = indexExpr($1, $3, yylineno);
+        $$ = indexExpr($1, $3, yyget_lineno(scanner));
+    }
+;
+
+slice_expr:
+    expr T_LBRACK expr T_COLON expr T_RBRACK {
+        $$ = sliceExpr($1, $3, $5, yyget_lineno(scanner));
+    }
+    | expr T_LBRACK T_COLON expr T_RBRACK {
+        $$ = sliceExpr($1, NULL, $4, yyget_lineno(scanner));
+    }
+    | expr T_LBRACK expr T_COLON T_RBRACK {
+        $$ = sliceExpr($1, $3, NULL, yyget_lineno(scanner));
     }
 ;
 
 expr_list:
     expr {
-        $$ = (struct ExprList*)calloc(1, sizeof(ExprList));
+        $$ = (struct ExprList*)astAlloc(sizeof(ExprList));
         $$->expr_count = 0;
         addExpr($$, $1);
     }
@@ -342,13 +344,13 @@ expr_list:
 
 key_value_expr:
     basic_lit T_COLON expr {
-        $$ = keyValueExpr($1, $3, yylineno);
+        $$ = keyValueExpr($1, $3, yyget_lineno(scanner));
     }
 ;
 
 key_value_list:
     key_value_expr {
-        $$ = (struct ExprList*)calloc(1, sizeof(ExprList));
+        $$ = (struct ExprList*)astAlloc(sizeof(ExprList));
         $$->expr_count = 0;
         addExpr($$, $1);
     }
@@ -364,101 +366,101 @@ key_value_list:
 
 composite_lit:
     T_LBRACK T_RBRACK {
-        ExprList* expr_list = (struct ExprList*)calloc(1, sizeof(ExprList));
+        ExprList* expr_list = (struct ExprList*)astAlloc(sizeof(ExprList));
         expr_list->expr_count = 0;
-        $$ = compositeLit(listType(yylineno), expr_list, yylineno);
+        $$ = compositeLit(listType(yyget_lineno(scanner)), expr_list, yyget_lineno(scanner));
     }
     | T_LBRACK expr_list T_RBRACK {
-        $$ = compositeLit(listType(yylineno), $2, yylineno);
+        $$ = compositeLit(listType(yyget_lineno(scanner)), $2, yyget_lineno(scanner));
     }
     | T_LBRACK T_NEWLINE expr_list T_RBRACK {
-        $$ = compositeLit(listType(yylineno), $3, yylineno);
+        $$ = compositeLit(listType(yyget_lineno(scanner)), $3, yyget_lineno(scanner));
     }
     | T_LBRACK expr_list T_NEWLINE T_RBRACK {
-        $$ = compositeLit(listType(yylineno), $2, yylineno);
+        $$ = compositeLit(listType(yyget_lineno(scanner)), $2, yyget_lineno(scanner));
     }
     | T_LBRACK T_NEWLINE expr_list T_NEWLINE T_RBRACK {
-        $$ = compositeLit(listType(yylineno), $3, yylineno);
+        $$ = compositeLit(listType(yyget_lineno(scanner)), $3, yyget_lineno(scanner));
     }
     | T_LBRACE T_RBRACE {
-        ExprList* key_value_list = (struct ExprList*)calloc(1, sizeof(ExprList));
+        ExprList* key_value_list = (struct ExprList*)astAlloc(sizeof(ExprList));
         key_value_list->expr_count = 0;
-        $$ = compositeLit(dictType(yylineno), key_value_list, yylineno);
+        $$ = compositeLit(dictType(yyget_lineno(scanner)), key_value_list, yyget_lineno(scanner));
     }
     | T_LBRACE key_value_list T_RBRACE {
-        $$ = compositeLit(dictType(yylineno), $2, yylineno);
+        $$ = compositeLit(dictType(yyget_lineno(scanner)), $2, yyget_lineno(scanner));
     }
     | T_LBRACE T_NEWLINE key_value_list T_RBRACE {
-        $$ = compositeLit(dictType(yylineno), $3, yylineno);
+        $$ = compositeLit(dictType(yyget_lineno(scanner)), $3, yyget_lineno(scanner));
     }
     | T_LBRACE key_value_list T_NEWLINE T_RBRACE {
-        $$ = compositeLit(dictType(yylineno), $2, yylineno);
+        $$ = compositeLit(dictType(yyget_lineno(scanner)), $2, yyget_lineno(scanner));
     }
     | T_LBRACE T_NEWLINE key_value_list T_NEWLINE T_RBRACE {
-        $$ = compositeLit(dictType(yylineno), $3, yylineno);
+        $$ = compositeLit(dictType(yyget_lineno(scanner)), $3, yyget_lineno(scanner));
     }
 ;
 
 selector_expr:
     ident T_PERIOD ident {
-        $$ = selectorExpr($1, $3, yylineno);
+        $$ = selectorExpr($1, $3, yyget_lineno(scanner));
     }
     | selector_expr T_PERIOD ident {
-        $$ = selectorExpr($1, $3, yylineno);
+        $$ = selectorExpr($1, $3, yyget_lineno(scanner));
     }
 ;
 
 call_expr:
     ident T_LPAREN T_RPAREN {
-        ExprList* expr_list = (struct ExprList*)calloc(1, sizeof(ExprList));
+        ExprList* expr_list = (struct ExprList*)astAlloc(sizeof(ExprList));
         expr_list->expr_count = 0;
-        $$ = callExpr($1, expr_list, yylineno);
+        $$ = callExpr($1, expr_list, yyget_lineno(scanner));
     }
     | ident T_LPAREN expr_list T_RPAREN {
-        $$ = callExpr($1, $3, yylineno);
+        $$ = callExpr($1, $3, yyget_lineno(scanner));
     }
     | selector_expr T_LPAREN T_RPAREN {
-        ExprList* expr_list = (struct ExprList*)calloc(1, sizeof(ExprList));
+        ExprList* expr_list = (struct ExprList*)astAlloc(sizeof(ExprList));
         expr_list->expr_count = 0;
-        $$ = callExpr($1, expr_list, yylineno);
+        $$ = callExpr($1, expr_list, yyget_lineno(scanner));
     }
     | selector_expr T_LPAREN expr_list T_RPAREN {
-        $$ = callExpr($1, $3, yylineno);
+        $$ = callExpr($1, $3, yyget_lineno(scanner));
     }
 ;
 
 decision_expr:
     bool_expr T_COLON call_expr {
-        $$ = decisionExpr($1, exprStmt($3, yylineno), yylineno);
+        $$ = decisionExpr($1, exprStmt($3, yyget_lineno(scanner)), yyget_lineno(scanner));
     }
     | bool_expr T_COLON return_stmt {
-        $$ = decisionExpr($1, $3, yylineno);
+        $$ = decisionExpr($1, $3, yyget_lineno(scanner));
     }
     | bool_expr T_COLON break_stmt {
-        $$ = decisionExpr($1, $3, yylineno);
+        $$ = decisionExpr($1, $3, yyget_lineno(scanner));
     }
 ;
 
 default_expr:
     T_DEFAULT T_COLON call_expr {
-        $$ = defaultExpr(exprStmt($3, yylineno), yylineno);
+        $$ = defaultExpr(exprStmt($3, yyget_lineno(scanner)), yyget_lineno(scanner));
     }
     | T_DEFAULT T_COLON return_stmt {
-        $$ = defaultExpr($3, yylineno);
+        $$ = defaultExpr($3, yyget_lineno(scanner));
     }
     | T_DEFAULT T_COLON break_stmt {
-        $$ = defaultExpr($3, yylineno);
+        $$ = defaultExpr($3, yyget_lineno(scanner));
     }
 ;
 
 decision_expr_list:
     decision_expr {
-        $$ = (struct ExprList*)calloc(1, sizeof(ExprList));
+        $$ = (struct ExprList*)astAlloc(sizeof(ExprList));
         $$->expr_count = 0;
         addExpr($$, $1);
     }
     | default_expr {
-        $$ = (struct ExprList*)calloc(1, sizeof(ExprList));
+        $$ = (struct ExprList*)astAlloc(sizeof(ExprList));
         $$->expr_count = 0;
         addExpr($$, $1);
     }
@@ -504,12 +506,12 @@ stmt:
 
 stmt_list:
     stmt {
-        $$ = (struct StmtList*)calloc(1, sizeof(StmtList));
+        $$ = (struct StmtList*)astAlloc(sizeof(StmtList));
         $$->stmt_count = 0;
         addStmt($$, $1);
     }
     | {
-        $$ = (struct StmtList*)calloc(1, sizeof(StmtList));
+        $$ = (struct StmtList*)astAlloc(sizeof(StmtList));
         $$->stmt_count = 0;
     }
     | stmt stmt_list {
@@ -523,275 +525,291 @@ stmt_list:
 
 assign_stmt:
     expr T_ASSIGN expr {
-        $$ = assignStmt($1, ASSIGN_tok, $3, yylineno);
+        $$ = assignStmt($1, ASSIGN_tok, $3, yyget_lineno(scanner));
+    }
+    | expr T_LBRACK T_RBRACK T_ASSIGN expr {
+        $$ = assignStmt(indexExpr($1, NULL, yyget_lineno(scanner)), ASSIGN_tok, $5, yyget_lineno(scanner));
     }
 ;
 
 return_stmt:
     T_RETURN expr {
-        $$ = returnStmt($2, yylineno);
+        $$ = returnStmt($2, yyget_lineno(scanner));
     }
 ;
 
 print_stmt:
     T_PRINT expr {
-        $$ = printStmt(NULL, $2, yylineno);
+        $$ = printStmt(NULL, $2, yyget_lineno(scanner));
     }
     | pretty_spec T_PRINT expr {
-        $$ = printStmt($1, $3, yylineno);
+        $$ = printStmt($1, $3, yyget_lineno(scanner));
     }
 ;
 
 echo_stmt:
     T_ECHO expr {
-        $$ = echoStmt(NULL, $2, yylineno);
+        $$ = echoStmt(NULL, $2, yyget_lineno(scanner));
     }
     | pretty_spec T_ECHO expr {
-        $$ = echoStmt($1, $3, yylineno);
+        $$ = echoStmt($1, $3, yyget_lineno(scanner));
     }
 ;
 
 expr_stmt:
     expr {
-        $$ = exprStmt($1, yylineno);
+        $$ = exprStmt($1, yyget_lineno(scanner));
     }
 ;
 
 decl_stmt:
     var_decl {
-        $$ = declStmt($1, yylineno);
+        $$ = declStmt($1, yyget_lineno(scanner));
     }
     | times_do_decl {
-        $$ = declStmt($1, yylineno);
+        $$ = declStmt($1, yyget_lineno(scanner));
     }
     | foreach_as_list_decl {
-        $$ = declStmt($1, yylineno);
+        $$ = declStmt($1, yyget_lineno(scanner));
     }
     | foreach_as_dict_decl {
-        $$ = declStmt($1, yylineno);
+        $$ = declStmt($1, yyget_lineno(scanner));
     }
     | func_decl {
-        $$ = declStmt($1, yylineno);
+        $$ = declStmt($1, yyget_lineno(scanner));
     }
 ;
 
 del_stmt:
     T_DEL ident {
-        $$ = delStmt($2, yylineno);
+        $$ = delStmt($2, yyget_lineno(scanner));
     }
     | T_DEL index_expr {
-        $$ = delStmt($2, yylineno);
+        $$ = delStmt($2, yyget_lineno(scanner));
     }
 ;
 
 exit_stmt:
     T_EXIT {
-        $$ = exitStmt(NULL, yylineno);
+        $$ = exitStmt(NULL, yyget_lineno(scanner));
     }
     | T_EXIT expr {
-        $$ = exitStmt($2, yylineno);
+        $$ = exitStmt($2, yyget_lineno(scanner));
     }
 ;
 
 function_table_stmt:
     T_FUNCTION_TABLE {
-        $$ = functionTableStmt(yylineno);
+        $$ = functionTableStmt(yyget_lineno(scanner));
     }
 ;
 
 block_stmt:
     stmt_list T_END {
-        $$ = blockStmt($1, yylineno);
+        $$ = blockStmt($1, yyget_lineno(scanner));
     }
 ;
 
 break_stmt:
     T_BREAK {
-        $$ = breakStmt(yylineno);
+        $$ = breakStmt(yyget_lineno(scanner));
     }
 ;
 
 type_spec:
     T_VOID {
-        $$ = typeSpec(K_BOOL, NULL, yylineno);
+        $$ = typeSpec(K_BOOL, NULL, yyget_lineno(scanner));
     }
     | T_VAR_BOOL {
-        $$ = typeSpec(K_BOOL, NULL, yylineno);
+        $$ = typeSpec(K_BOOL, NULL, yyget_lineno(scanner));
     }
     | T_VAR_NUMBER {
-        $$ = typeSpec(K_NUMBER, NULL, yylineno);
+        $$ = typeSpec(K_NUMBER, NULL, yyget_lineno(scanner));
     }
     | T_VAR_STRING {
-        $$ = typeSpec(K_STRING, NULL, yylineno);
+        $$ = typeSpec(K_STRING, NULL, yyget_lineno(scanner));
     }
     | T_VAR_ANY {
-        $$ = typeSpec(K_ANY, NULL, yylineno);
+        $$ = typeSpec(K_ANY, NULL, yyget_lineno(scanner));
     }
     | T_VAR_LIST {
-        $$ = typeSpec(K_LIST, NULL, yylineno);
+        $$ = typeSpec(K_LIST, NULL, yyget_lineno(scanner));
     }
     | T_VAR_DICT {
-        $$ = typeSpec(K_DICT, NULL, yylineno);
+        $$ = typeSpec(K_DICT, NULL, yyget_lineno(scanner));
     }
     | T_VOID sub_type_spec {
-        $$ = typeSpec(K_BOOL, $2, yylineno);
+        $$ = typeSpec(K_BOOL, $2, yyget_lineno(scanner));
     }
     | T_VAR_BOOL sub_type_spec {
-        $$ = typeSpec(K_BOOL, $2, yylineno);
+        $$ = typeSpec(K_BOOL, $2, yyget_lineno(scanner));
     }
     | T_VAR_NUMBER sub_type_spec {
-        $$ = typeSpec(K_NUMBER, $2, yylineno);
+        $$ = typeSpec(K_NUMBER, $2, yyget_lineno(scanner));
     }
     | T_VAR_STRING sub_type_spec {
-        $$ = typeSpec(K_STRING, $2, yylineno);
+        $$ = typeSpec(K_STRING, $2, yyget_lineno(scanner));
     }
     | T_VAR_ANY sub_type_spec {
-        $$ = typeSpec(K_ANY, $2, yylineno);
+        $$ = typeSpec(K_ANY, $2, yyget_lineno(scanner));
     }
 ;
 
 sub_type_spec:
     T_VAR_LIST {
-        $$ = typeSpec(K_LIST, NULL, yylineno);
+        $$ = typeSpec(K_LIST, NULL, yyget_lineno(scanner));
     }
     | T_VAR_DICT {
-        $$ = typeSpec(K_DICT, NULL, yylineno);
+        $$ = typeSpec(K_DICT, NULL, yyget_lineno(scanner));
     }
     | T_VAR_LIST sub_type_spec {
-        $$ = typeSpec(K_LIST, $2, yylineno);
+        $$ = typeSpec(K_LIST, $2, yyget_lineno(scanner));
     }
     | T_VAR_DICT sub_type_spec {
-        $$ = typeSpec(K_DICT, $2, yylineno);
+        $$ = typeSpec(K_DICT, $2, yyget_lineno(scanner));
     }
 ;
 
 pretty_spec:
     T_PRETTY {
-        $$ = prettySpec(yylineno);
+        $$ = prettySpec(yyget_lineno(scanner));
     }
 ;
 
 var_decl:
     type_spec ident T_ASSIGN expr {
-        $$ = varDecl($1, $2, $4, yylineno);
+        $$ = varDecl($1, $2, $4, yyget_lineno(scanner));
     }
 ;
 
 func_decl:
     func_type block_stmt {
-        $$ = funcDecl($1->func_type, $1->ident, $2, NULL, yylineno);
+        $$ = funcDecl($1->func_type, $1->ident, $2, NULL, yyget_lineno(scanner));
         free($1);
     }
     | func_type block_stmt decision_block {
-        $$ = funcDecl($1->func_type, $1->ident, $2, $3, yylineno);
+        $$ = funcDecl($1->func_type, $1->ident, $2, $3, yyget_lineno(scanner));
         free($1);
     }
 ;
 
 times_do_decl:
     expr T_TIMES_DO T_ARROW call_expr {
-        $$ = timesDo($1, NULL, $4, yylineno);
+        $$ = timesDo($1, NULL, $4, yyget_lineno(scanner));
     }
     | expr T_TIMES_DO ident T_ARROW call_expr {
-        $$ = timesDo($1, $3, $5, yylineno);
+        $$ = timesDo($1, $3, $5, yyget_lineno(scanner));
     }
     | expr T_TIMES_DO T_AS ident T_ARROW call_expr {
-        $$ = timesDo($1, $4, $6, yylineno);
+        $$ = timesDo($1, $4, $6, yyget_lineno(scanner));
     }
 ;
 
 foreach_as_list_decl:
     T_FOREACH expr T_AS ident T_ARROW call_expr {
-        $$ = foreachAsList($2, NULL, $4, $6, yylineno);
+        $$ = foreachAsList($2, NULL, $4, $6, yyget_lineno(scanner));
     }
     | T_FOREACH expr T_AS ident T_COMMA ident T_ARROW call_expr {
-        $$ = foreachAsList($2, $4, $6, $8, yylineno);
+        $$ = foreachAsList($2, $4, $6, $8, yyget_lineno(scanner));
     }
 ;
 
 foreach_as_dict_decl:
     T_FOREACH expr T_AS ident T_COLON ident T_ARROW call_expr {
-        $$ = foreachAsDict($2, NULL, $4, $6, $8, yylineno);
+        $$ = foreachAsDict($2, NULL, $4, $6, $8, yyget_lineno(scanner));
     }
     | T_FOREACH expr T_AS ident T_COMMA ident T_COLON ident T_ARROW call_expr {
-        $$ = foreachAsDict($2, $4, $6, $8, $10, yylineno);
+        $$ = foreachAsDict($2, $4, $6, $8, $10, yyget_lineno(scanner));
     }
 ;
 
 import:
-    T_IMPORT module_selector {
-        $$ = importSpec($2, NULL, NULL, NULL, yylineno);
+    import_keyword module_selector {
+        $$ = importSpec($2, NULL, NULL, NULL, $1);
+    }
+    | import_keyword module_selector T_AS ident {
+        $$ = importSpec($2, $4, NULL, NULL, $1);
     }
-    | T_IMPORT module_selector T_AS ident {
-        $$ = importSpec($2, $4, NULL, NULL, yylineno);
+    | from_keyword module_selector T_IMPORT asterisk_spec {
+        $$ = importSpec($2, NULL, NULL, $4, $1);
     }
-    | T_FROM module_selector T_IMPORT asterisk_spec {
-        $$ = importSpec($2, NULL, NULL, $4, yylineno);
+    | from_keyword module_selector T_IMPORT alias_expr_list {
+        $$ = importSpec($2, NULL, $4, NULL, $1);
     }
-    | T_FROM module_selector T_IMPORT alias_expr_list {
-        $$ = importSpec($2, NULL, $4, NULL, yylineno);
+;
+
+// The line number is taken from the keyword since the import is reduced only after the newline is read
+import_keyword:
+    T_IMPORT {
+        $$ = yyget_lineno(scanner);
+    }
+;
+
+from_keyword:
+    T_FROM {
+        $$ = yyget_lineno(scanner);
     }
 ;
 
 module_selector:
     ident {
-        $$ = moduleSelector(NULL, $1, NULL, yylineno);
+        $$ = moduleSelector(NULL, $1, NULL, yyget_lineno(scanner));
     }
     | ident T_PERIOD module_selector {
-        $$ = moduleSelector(NULL, $1, $3, yylineno);
+        $$ = moduleSelector(NULL, $1, $3, yyget_lineno(scanner));
     }
     | ident T_QUO module_selector {
-        $$ = moduleSelector(NULL, $1, $3, yylineno);
+        $$ = moduleSelector(NULL, $1, $3, yyget_lineno(scanner));
     }
     | ident T_BACKSLASH module_selector {
-        $$ = moduleSelector(NULL, $1, $3, yylineno);
+        $$ = moduleSelector(NULL, $1, $3, yyget_lineno(scanner));
     }
     | parent_dir_spec {
-        $$ = moduleSelector($1, NULL, NULL, yylineno);
+        $$ = moduleSelector($1, NULL, NULL, yyget_lineno(scanner));
     }
     | parent_dir_spec T_PERIOD module_selector {
-        $$ = moduleSelector($1, NULL, $3, yylineno);
+        $$ = moduleSelector($1, NULL, $3, yyget_lineno(scanner));
     }
     | parent_dir_spec T_QUO module_selector {
-        $$ = moduleSelector($1, NULL, $3, yylineno);
+        $$ = moduleSelector($1, NULL, $3, yyget_lineno(scanner));
     }
     | parent_dir_spec T_BACKSLASH module_selector {
-        $$ = moduleSelector($1, NULL, $3, yylineno);
+        $$ = moduleSelector($1, NULL, $3, yyget_lineno(scanner));
     }
     | parent_dir_spec module_selector {
-        $$ = moduleSelector($1, NULL, $2, yylineno);
+        $$ = moduleSelector($1, NULL, $2, yyget_lineno(scanner));
     }
 ;
 
 parent_dir_spec:
     T_PERIOD T_PERIOD {
-        $$ = parentDirSpec(yylineno);
+        $$ = parentDirSpec(yyget_lineno(scanner));
     }
 ;
 
 asterisk_spec:
     T_MUL {
-        $$ = asteriskSpec(yylineno);
+        $$ = asteriskSpec(yyget_lineno(scanner));
     }
 ;
 
 field_spec:
     type_spec ident {
-        $$ = fieldSpec($1, $2, yylineno);
+        $$ = fieldSpec($1, $2, yyget_lineno(scanner));
     }
 ;
 
 optional_field_spec:
     type_spec ident T_ASSIGN expr {
-        $$ = optionalFieldSpec($1, $2, $4, yylineno);
+        $$ = optionalFieldSpec($1, $2, $4, yyget_lineno(scanner));
     }
 ;
 
 field_list_spec:
     field_spec {
-        SpecList* spec_list = (struct SpecList*)calloc(1, sizeof(SpecList));
+        SpecList* spec_list = (struct SpecList*)astAlloc(sizeof(SpecList));
         spec_list->spec_count = 0;
-        $$ = fieldListSpec(spec_list, yylineno);
+        $$ = fieldListSpec(spec_list, yyget_lineno(scanner));
         addSpec($$->v.field_list_spec->list, $1);
     }
     | field_spec T_COMMA field_list_spec {
@@ -814,9 +832,9 @@ field_list_spec:
 
 optional_field_list_spec:
     optional_field_spec {
-        SpecList* spec_list = (struct SpecList*)calloc(1, sizeof(SpecList));
+        SpecList* spec_list = (struct SpecList*)astAlloc(sizeof(SpecList));
         spec_list->spec_count = 0;
-        $$ = fieldListSpec(spec_list, yylineno);
+        $$ = fieldListSpec(spec_list, yyget_lineno(scanner));
         addSpec($$->v.field_list_spec->list, $1);
     }
     | optional_field_spec T_COMMA optional_field_list_spec {
@@ -831,30 +849,30 @@ optional_field_list_spec:
 
 func_type:
     type_spec T_DEF ident T_LPAREN T_RPAREN T_NEWLINE {
-        SpecList* spec_list = (struct SpecList*)calloc(1, sizeof(SpecList));
+        SpecList* spec_list = (struct SpecList*)astAlloc(sizeof(SpecList));
         spec_list->spec_count = 0;
-        Spec* params = fieldListSpec(spec_list, yylineno);
-        Spec* func_type = funcType(params, $1, yylineno);
+        Spec* params = fieldListSpec(spec_list, yyget_lineno(scanner));
+        Spec* func_type = funcType(params, $1, yyget_lineno(scanner));
         $$ = funcDeclCom(func_type, $3);
     }
     | type_spec T_DEF ident T_LPAREN field_list_spec T_RPAREN T_NEWLINE {
-        Spec* func_type = funcType($5, $1, yylineno);
+        Spec* func_type = funcType($5, $1, yyget_lineno(scanner));
         $$ = funcDeclCom(func_type, $3);
     }
 ;
 
 decision_block:
     T_LBRACE decision_expr_list T_RBRACE {
-        $$ = decisionBlock($2, yylineno);
+        $$ = decisionBlock($2, yyget_lineno(scanner));
     }
     | T_LBRACE T_NEWLINE decision_expr_list T_RBRACE {
-        $$ = decisionBlock($3, yylineno);
+        $$ = decisionBlock($3, yyget_lineno(scanner));
     }
     | T_LBRACE decision_expr_list T_NEWLINE T_RBRACE {
-        $$ = decisionBlock($2, yylineno);
+        $$ = decisionBlock($2, yyget_lineno(scanner));
     }
     | T_LBRACE T_NEWLINE decision_expr_list T_NEWLINE T_RBRACE {
-        $$ = decisionBlock($3, yylineno);
+        $$ = decisionBlock($3, yyget_lineno(scanner));
     }
 ;
 
@@ -0,0 +1,100 @@
+#!/bin/bash
+
+DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" >/dev/null 2>&1 && pwd )"
+
+# The cache is written into a directory of its own, the user's cache is left untouched
+unset CHAOS_NO_AST_CACHE
+export XDG_CACHE_HOME=$(mktemp -d)
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$XDG_CACHE_HOME" "$WORK_DIR"' EXIT
+
+CACHE_DIR="$XDG_CACHE_HOME/chaos/ast"
+
+cat > "$WORK_DIR/cached.kaos" <<'EOF'
+void def greet()
+    print "parsed"
+end
+EOF
+
+cat > "$WORK_DIR/main.kaos" <<'EOF'
+import cached
+
+cached.greet()
+EOF
+
+failed=false
+
+expect() {
+    name=$1
+    out=$2
+    test=$3
+
+    echo "Testing AST cache: ${name}"
+
+    if [ "$test" == "$out" ]
+    then
+        echo "OK"
+    else
+        echo "$test"
+        echo "Fail"
+        failed=true
+    fi
+}
+
+cache_files() {
+    find "$CACHE_DIR" -name '*.kast' 2>/dev/null | wc -l | tr -d ' '
+}
+
+# Runs the program with the cache reporting on stderr, the module's lookups and writes are kept in $trace
+run() {
+    test=$(CHAOS_AST_CACHE_DEBUG=1 "$@" chaos "$WORK_DIR/main.kaos" 2>"$WORK_DIR/trace")
+    trace=$(sed -n 's/^AST cache \([a-z]*\): .*cached\.kaos$/\1/p' "$WORK_DIR/trace" | tr '\n' ' ')
+}
+
+run env
+expect "miss" "parsed" "$test"
+expect "miss is parsed and written" "miss write " "$trace"
+expect "miss writes the cache" "1" "$(cache_files)"
+
+cache_file=$(find "$CACHE_DIR" -name '*.kast' | head -n 1)
+cp "$cache_file" "$WORK_DIR/cache.kast"
+
+run env
+expect "hit" "parsed" "$test"
+expect "hit is not parsed" "hit " "$trace"
+cmp -s "$cache_file" "$WORK_DIR/cache.kast"
+expect "hit leaves the entry alone" "0" "$?"
+
+# The string literal is swapped in the entry only, parsing the source would still print "parsed"
+perl -pi -e 's/parsed/cached/' "$cache_file"
+run env
+expect "hit runs the cached AST" "cached" "$test"
+expect "hit runs the cached AST without parsing" "hit " "$trace"
+
+head -c 20 "$WORK_DIR/cache.kast" > "$cache_file"
+run env
+expect "truncated" "parsed" "$test"
+expect "truncated is rejected" "reject write " "$trace"
+cmp -s "$cache_file" "$WORK_DIR/cache.kast"
+expect "truncated is written again" "0" "$?"
+
+printf 'corrupted' >> "$cache_file"
+run env
+expect "corrupted" "parsed" "$test"
+expect "corrupted is rejected" "reject write " "$trace"
+
+sed -i.bak 's/print "parsed"/print "edited"/' "$WORK_DIR/cached.kaos"
+run env
+expect "edited" "edited" "$test"
+expect "edited is a miss" "miss write " "$trace"
+expect "edited writes a new entry" "2" "$(cache_files)"
+
+rm -rf "$CACHE_DIR"
+run env CHAOS_NO_AST_CACHE=1
+expect "disabled" "edited" "$test"
+expect "disabled looks nothing up" "" "$trace"
+expect "disabled writes nothing" "0" "$(cache_files)"
+
+if [ "$failed" = true ] ; then
+    exit 1
+fi
@@ -7,6 +7,8 @@ for %%f in (tests\*.kaos) do (
 
     SET ignore=false
     IF "!testname!" == "syntax_error" SET ignore=true
+    IF "!testname!" == "module_syntax_error" SET ignore=true
+    IF "!testname!" == "module_missing" SET ignore=true
     IF !ignore! == true (
         ECHO.
         ECHO Ignoring !filename!
@@ -29,6 +31,8 @@ for %%f in (tests\*.kaos) do (
 
     SET ignore=false
     IF "!testname!" == "syntax_error" SET ignore=true
+    IF "!testname!" == "module_syntax_error" SET ignore=true
+    IF "!testname!" == "module_missing" SET ignore=true
     IF !ignore! == true (
         ECHO.
         ECHO Ignoring !filename!
@@ -28,7 +28,7 @@ for filepath in $(find $DIR -maxdepth 1 -name '*.kaos'); do
     testname="${filename%.*}"
     out=$(<"$DIR/$testname.out")
 
-    SKIP_TESTS="syntax_error"
+    SKIP_TESTS="syntax_error module_syntax_error module_missing"
 
     if echo $SKIP_TESTS | grep -w $testname > /dev/null; then
         continue
@@ -58,7 +58,7 @@ for filepath in $(find $DIR -maxdepth 1 -name '*.kaos'); do
     testname="${filename%.*}"
     out=$(<"$DIR/$testname.out")
 
-    SKIP_TESTS="syntax_error"
+    SKIP_TESTS="syntax_error module_syntax_error module_missing"
 
     if echo $SKIP_TESTS | grep -w $testname > /dev/null; then
         continue
@@ -106,6 +106,43 @@ int KAOS_EXPORT Kaos_dictionary()
     return 0;
 }
 
+char *json_params_name[] = {
+    "dict1"
+};
+unsigned json_params_type[] = {
+    K_DICT
+};
+unsigned json_params_secondary_type[] = {
+    K_ANY
+};
+unsigned short json_params_length = (unsigned short) sizeof(json_params_type) / sizeof(unsigned);
+int KAOS_EXPORT Kaos_json()
+{
+    size_t len = kaos.dumpVariableToStream(json_params_name[0], stdout, false, false, true);
+    printf("\n%zu\n", len);
+    return 0;
+}
+
+char *parse_params_name[] = {};
+unsigned parse_params_type[] = {};
+unsigned parse_params_secondary_type[] = {};
+unsigned short parse_params_length = 0;
+int KAOS_EXPORT Kaos_parse()
+{
+    kaos.parseJson("{\"a\": [1, 2.5, true], \"b\": {\"c\": \"foo\\nbar\"}, \"d\": null}");
+    return 0;
+}
+
+char *fail_params_name[] = {};
+unsigned fail_params_type[] = {};
+unsigned fail_params_secondary_type[] = {};
+unsigned short fail_params_length = 0;
+int KAOS_EXPORT Kaos_fail()
+{
+    kaos.raiseError("Raised from the example extension!");
+    return 0;
+}
+
 char *optional_test_params_name[] = {
     "param1",
     "param2"
@@ -139,6 +176,9 @@ int KAOS_EXPORT KaosRegister(struct Kaos _kaos)
     kaos.defineFunction("complex", K_VOID, K_ANY, complex_params_name, complex_params_type, complex_params_secondary_type, complex_params_length, NULL, 0);
     kaos.defineFunction("array", K_LIST, K_ANY, array_params_name, array_params_type, array_params_secondary_type, array_params_length, NULL, 0);
     kaos.defineFunction("dictionary", K_DICT, K_ANY, dictionary_params_name, dictionary_params_type, dictionary_params_secondary_type, dictionary_params_length, NULL, 0);
+    kaos.defineFunction("json", K_VOID, K_ANY, json_params_name, json_params_type, json_params_secondary_type, json_params_length, NULL, 0);
+    kaos.defineFunction("parse", K_DICT, K_ANY, parse_params_name, parse_params_type, parse_params_secondary_type, parse_params_length, NULL, 0);
+    kaos.defineFunction("fail", K_VOID, K_ANY, fail_params_name, fail_params_type, fail_params_secondary_type, fail_params_length, NULL, 0);
 
 
     // Functions with optional parameters
@@ -51,7 +51,7 @@ for filepath in $(find $DIR -maxdepth 1 -name '*.kaos'); do
     testname="${filename%.*}"
     out=$(<"$DIR/$testname.out")
 
-    SKIP_TESTS="nonewline function decision everything syntax_error"
+    SKIP_TESTS="nonewline function decision everything syntax_error module_syntax_error module_missing"
 
     if echo $SKIP_TESTS | grep -w $testname > /dev/null; then
         continue
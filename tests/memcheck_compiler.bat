@@ -8,6 +8,8 @@ FOR %%f in (*.kaos) do (
     SET ignore=false
     IF "!filename:~0,5!" == "exit_" SET ignore=true
     IF "!testname!" == "syntax_error" SET ignore=true
+    IF "!testname!" == "module_syntax_error" SET ignore=true
+    IF "!testname!" == "module_missing" SET ignore=true
     IF !ignore! == true (
         ECHO.
         ECHO Ignoring memcheck for !filename!
@@ -29,6 +31,8 @@ FOR %%f in (*.kaos) do (
     SET ignore=false
     IF "!filename:~0,5!" == "exit_" SET ignore=true
     IF "!testname!" == "syntax_error" SET ignore=true
+    IF "!testname!" == "module_syntax_error" SET ignore=true
+    IF "!testname!" == "module_missing" SET ignore=true
     IF !ignore! == true (
         ECHO.
         ECHO Ignoring memcheck for !filename!
@@ -13,7 +13,7 @@ for filepath in $(find $DIR -maxdepth 1 -name '*.kaos'); do
         continue
     fi
 
-    SKIP_TESTS="syntax_error"
+    SKIP_TESTS="syntax_error module_syntax_error module_missing"
 
     if echo $SKIP_TESTS | grep -w $testname > /dev/null; then
         continue
@@ -36,7 +36,7 @@ for filepath in $(find $DIR -maxdepth 1 -name '*.kaos'); do
         continue
     fi
 
-    SKIP_TESTS="syntax_error"
+    SKIP_TESTS="syntax_error module_syntax_error module_missing"
 
     if echo $SKIP_TESTS | grep -w $testname > /dev/null; then
         continue
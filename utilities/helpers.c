@@ -63,41 +63,27 @@ char *trim_string(char *str) {
     return str;
 }
 
-#if defined(_WIN32) || defined(_WIN64) || defined(__CYGWIN__)
-char *fileGetContents(char *file_path) {
-    char *file_content = "";
-    char str[MAXCHAR];
-    FILE * fp = fopen(file_path, "r");
-    if (fp) {
-        while (fgets(str, MAXCHAR, fp) != NULL) {
-            char *line = malloc(1 + strlen(str));
-            strcpy(line, str);
-            file_content = strcat_ext(file_content, line);
-            free(line);
-        }
-        fclose(fp);
-    } else {
-        append_to_array_without_malloc(&free_string_stack, file_path);
-        throw_error(E_MODULE_IS_EMPTY_OR_NOT_EXISTS_ON_PATH, file_path);
-    }
-    return file_content;
-}
-#else
 char *fileGetContents(char *file_path) {
     char *file_buffer = NULL;
     long length;
+#if defined(_WIN32) || defined(_WIN64) || defined(__CYGWIN__)
+    // Text mode translates the line endings, fewer characters than the file size may be read
+    FILE * f = fopen(file_path, "r");
+#else
     FILE * f = fopen(file_path, "rb");
+#endif
     if (f) {
         fseek(f, 0, SEEK_END);
         length = ftell(f);
         fseek(f, 0, SEEK_SET);
         file_buffer = malloc(length + 1);
-        file_buffer[length] = '\0';
         if (file_buffer) {
-            if (fread(file_buffer, 1, length, f) != length && ferror(f)) {
+            size_t read_length = fread(file_buffer, 1, length, f);
+            if (read_length != (size_t)length && ferror(f)) {
                 append_to_array_without_malloc(&free_string_stack, file_path);
                 throw_error(E_MODULE_IS_EMPTY_OR_NOT_EXISTS_ON_PATH, file_path);
             }
+            file_buffer[read_length] = '\0';
         }
         fclose(f);
     } else {
@@ -106,7 +92,81 @@ char *fileGetContents(char *file_path) {
     }
     return file_buffer;
 }
+
+bool fileReadSource(char *file_path, source_buffer *source) {
+#if defined(_WIN32) || defined(_WIN64) || defined(__CYGWIN__)
+    FILE * f = fopen(file_path, "r");
+    if (!f)
+        return false;
+
+    fseek(f, 0, SEEK_END);
+    long file_size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    source->capacity = file_size + __KAOS_SOURCE_PADDING__;
+    source->arr = malloc(source->capacity);
+    size_t length = fread(source->arr, 1, file_size, f);
+    if (length != (size_t)file_size && ferror(f)) {
+        fclose(f);
+        free(source->arr);
+        source->arr = NULL;
+        return false;
+    }
+    fclose(f);
+#else
+    struct stat file_stat;
+    int fd = open(file_path, O_RDONLY);
+    if (fd == -1 || fstat(fd, &file_stat) == -1) {
+        if (fd != -1)
+            close(fd);
+        return false;
+    }
+
+    size_t length = file_stat.st_size;
+    size_t page_size = sysconf(_SC_PAGESIZE);
+    source->capacity = (length + __KAOS_SOURCE_PADDING__ + page_size - 1) / page_size * page_size;
+
+    // Reserve zeroed pages for the file and its padding, then map the file over them.
+    // The mapping is private so that flex can write into it while scanning.
+    source->arr = mmap(NULL, source->capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (source->arr != MAP_FAILED && length != 0) {
+        void *file_map = mmap(source->arr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0);
+        if (file_map == MAP_FAILED) {
+            munmap(source->arr, source->capacity);
+            source->arr = MAP_FAILED;
+        }
+    }
+    close(fd);
+
+    if (source->arr == MAP_FAILED) {
+        source->arr = NULL;
+        return false;
+    }
+#endif
+
+    source->arr[length] = '\n';
+    source->arr[length + 1] = '\0';
+    source->arr[length + 2] = '\0';
+    source->length = length + __KAOS_SOURCE_PADDING__;
+    return true;
+}
+
+source_buffer fileGetSource(char *file_path) {
+    source_buffer source;
+    if (!fileReadSource(file_path, &source)) {
+        append_to_array_without_malloc(&free_string_stack, file_path);
+        throw_error(E_MODULE_IS_EMPTY_OR_NOT_EXISTS_ON_PATH, file_path);
+    }
+    return source;
+}
+
+void freeSource(source_buffer *source) {
+#if defined(_WIN32) || defined(_WIN64) || defined(__CYGWIN__)
+    free(source->arr);
+#else
+    munmap(source->arr, source->capacity);
 #endif
+    source->arr = NULL;
+}
 
 char *strcat_ext(char *s1, const char *s2)
 {
@@ -293,23 +353,25 @@ char *remove_ext(char* myStr, char extSep, char pathSep) {
 }
 
 char* str_replace(char *target, const char *needle, const char *replacement) {
-    char buffer[4096] = { 0 };
-    char *insert_point = &buffer[0];
-    const char *tmp = target;
     size_t needle_len = strlen(needle);
     size_t repl_len = strlen(replacement);
+    size_t target_len = strlen(target);
 
+    // count the occurrences first so that the result is allocated once
     size_t counter = 0;
+    const char *tmp = target;
+    const char *p;
+    while (needle_len != 0 && (p = strstr(tmp, needle)) != NULL) {
+        counter++;
+        tmp = p + needle_len;
+    }
 
-    while (1) {
-        const char *p = strstr(tmp, needle);
+    char* new_target = (char*) malloc((1 + target_len - counter * needle_len + counter * repl_len) * sizeof(char));
+    char *insert_point = new_target;
+    tmp = target;
 
-        // walked past last occurrence of needle; copy remaining part
-        if (p == NULL) {
-            strcpy(insert_point, tmp);
-            break;
-        }
-        counter++;
+    for (size_t i = 0; i < counter; i++) {
+        p = strstr(tmp, needle);
 
         // copy part before needle
         memcpy(insert_point, tmp, p - tmp);
@@ -323,9 +385,8 @@ char* str_replace(char *target, const char *needle, const char *replacement) {
         tmp = p + needle_len;
     }
 
-    // write altered string back to target
-    char* new_target = (char*) malloc((1 + strlen(target) + counter * (repl_len - needle_len)) * sizeof(char));
-    strcpy(new_target, buffer);
+    // copy remaining part
+    strcpy(insert_point, tmp);
     return new_target;
 }
 
@@ -361,54 +422,61 @@ void freeFreeStringStack() {
 }
 
 char* escape_the_sequences_in_string_literal(char* string) {
-    char* new_string = malloc(strlen(string) + 1);
-    strcpy(new_string, string);
-
-    for (long long i = 0; i < (long long) strlen(new_string); i++){
-        if (new_string[i] == '\\') {
-            switch (new_string[i+1]) {
+    size_t len = strlen(string);
+    char* new_string = malloc(len + 1);
+    size_t j = 0;
+
+    for (size_t i = 0; i < len; i++) {
+        char c = string[i];
+        if (c == '\\') {
+            switch (string[i+1]) {
             case '\\':
-                remove_nth_char(new_string, i);
+                c = '\\';
+                i++;
                 break;
             case 'a':
-                new_string[i+1] = '\a';
-                remove_nth_char(new_string, i);
+                c = '\a';
+                i++;
                 break;
             case 'b':
-                new_string[i+1] = '\b';
-                remove_nth_char(new_string, i);
+                c = '\b';
+                i++;
                 break;
             case 'f':
-                new_string[i+1] = '\f';
-                remove_nth_char(new_string, i);
+                c = '\f';
+                i++;
                 break;
             case 'n':
-                new_string[i+1] = '\n';
-                remove_nth_char(new_string, i);
+                c = '\n';
+                i++;
                 break;
             case 'r':
-                new_string[i+1] = '\r';
-                remove_nth_char(new_string, i);
+                c = '\r';
+                i++;
                 break;
             case 't':
-                new_string[i+1] = '\t';
-                remove_nth_char(new_string, i);
+                c = '\t';
+                i++;
                 break;
             case 'v':
-                new_string[i+1] = '\v';
-                remove_nth_char(new_string, i);
+                c = '\v';
+                i++;
                 break;
             case '"':
-                remove_nth_char(new_string, i);
+                c = '"';
+                i++;
                 break;
             case '\'':
-                remove_nth_char(new_string, i);
+                c = '\'';
+                i++;
                 break;
             default:
                 break;
             }
         }
+        new_string[j++] = c;
     }
+    new_string[j] = '\0';
 
     return new_string;
 }
@@ -39,11 +39,28 @@ typedef struct string_array {
 
 string_array free_string_stack;
 
+/*
+  Source files are mapped into memory in one go (read with a single sized
+  read on Windows) and padded with a newline that terminates the last line
+  and the two null bytes that flex needs to scan the buffer in place. The
+  length counts the padding, capacity is the size of the mapping.
+*/
+#define __KAOS_SOURCE_PADDING__ 3
+
+typedef struct source_buffer {
+    char *arr;
+    size_t length;
+    size_t capacity;
+} source_buffer;
+
 #include "../interpreter/function.h"
 
 char *longlong_to_string(long long value, char *result, unsigned short base);
 char *trim_string(char *str);
 char *fileGetContents(char *file_path);
+bool fileReadSource(char *file_path, source_buffer *source);
+source_buffer fileGetSource(char *file_path);
+void freeSource(source_buffer *source);
 char *strcat_ext(char *s1, const char *s2);
 char *snprintf_concat_int(char *s1, char *format, long long i);
 char *snprintf_concat_float(char *s1, char *format, double f);
@@ -80,6 +97,9 @@ char *trim(char *s);
 #   define GetCurrentDir _getcwd
 #else
 #   include <unistd.h>
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
 #   define GetCurrentDir getcwd
 #endif
 
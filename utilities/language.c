@@ -23,17 +23,16 @@
 #include "language.h"
 #include "helpers.h"
 
-extern int yylineno;
 extern FILE* tmp_stdin;
 
-void yyerror_msg(char* error_name, char* current_module, char* cause) {
+void yyerror_msg(char* error_name, char* current_module, int lineno, char* cause) {
     char error_name_msg[__KAOS_MSG_LINE_LENGTH__];
     char info[__KAOS_MSG_LINE_LENGTH__];
     char line_msg[__KAOS_MSG_LINE_LENGTH__];
     int indent = 2;
 
     sprintf(error_name_msg, "%*c%s:", indent, ' ', error_name);
-    sprintf(info, "%*cFile: \"%s\", line %d, cause: %s", indent * 2, ' ', current_module, yylineno, cause);
+    sprintf(info, "%*cFile: \"%s\", line %d, cause: %s", indent * 2, ' ', current_module, lineno, cause);
     char* info_msg = str_replace(info, "\n", "\\n");
 
     FILE* fp_module = NULL;
@@ -52,7 +51,7 @@ void yyerror_msg(char* error_name, char* current_module, char* cause) {
         line = malloc(4);
         strcpy(line, "???");
     } else {
-        line = get_nth_line(fp_module, yylineno);
+        line = get_nth_line(fp_module, lineno);
 #ifndef CHAOS_COMPILER
         if (fp_module != tmp_stdin)
 #endif
@@ -73,6 +73,6 @@
 
 #include "platform.h"
 
-void yyerror_msg(char* error_name, char* current_module, char* cause);
+void yyerror_msg(char* error_name, char* current_module, int lineno, char* cause);
 
 #endif
@@ -23,8 +23,6 @@
 #if !defined(_WIN32) && !defined(_WIN64) && !defined(__CYGWIN__)
 #   include "shell.h"
 
-extern unsigned long long shell_indicator_block_counter;
-
 unsigned long long suggestions_length = __KAOS_LANGUAGE_KEYWORD_COUNT__;
 char *suggestions[1000] = {
     "exit",
@@ -104,7 +102,7 @@ int tab_key_pressed(int count, int key) {
     return 0;
 }
 
-int shell_readline(char *buf) {
+int shell_readline(char *buf, bool block) {
     rl_command_func_t up_arrow_key_pressed;
     rl_command_func_t down_arrow_key_pressed;
     rl_command_func_t esc_key_pressed;
@@ -115,7 +113,7 @@ int shell_readline(char *buf) {
 
     char *line;
 
-    if (is_interactive && shell_indicator_block_counter > 0) {
+    if (is_interactive && block) {
         line = readline(__KAOS_SHELL_INDICATOR_BLOCK__);
     } else {
         line = readline(__KAOS_SHELL_INDICATOR__);
@@ -39,7 +39,7 @@ int esc_key_pressed(int count, int key);
 int ctrl_d_key_pressed();
 int tab_key_pressed(int count, int key);
 
-int shell_readline(char *buf);
+int shell_readline(char *buf, bool block);
 
 char **suggestion_completion(const char *, int, int);
 char *suggestion_generator(const char *, int);
@@ -0,0 +1,301 @@
+/*
+ * Description: Byte string module of the Chaos Programming Language's source
+ *
+ * Copyright (c) 2019-2021 Chaos Language Development Authority <info@chaos-lang.org>
+ *
+ * License: GNU General Public License v3.0
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors: M. Mert Yildiran <me@mertyildiran.com>
+ */
+
+#include "bytes.h"
+
+cpu_bytes_equal_fn cpu_bytes_equal_impl = cpu_bytes_equal_resolve;
+cpu_bytes_mismatch_fn cpu_bytes_mismatch_impl = cpu_bytes_mismatch_resolve;
+cpu_bytes_find_fn cpu_bytes_find_impl = cpu_bytes_find_resolve;
+cpu_bytes_scan_string_fn cpu_bytes_scan_string_impl = cpu_bytes_scan_string_resolve;
+
+bool cpu_bytes_equal(const char* a, size_t a_len, const char* b, size_t b_len)
+{
+    if (a_len != b_len)
+        return false;
+    if (a == b || a_len == 0)
+        return true;
+    return cpu_bytes_equal_impl(a, b, a_len);
+}
+
+int cpu_bytes_compare(const char* a, size_t a_len, const char* b, size_t b_len)
+{
+    size_t len = a_len < b_len ? a_len : b_len;
+    size_t i = a == b ? len : cpu_bytes_mismatch_impl(a, b, len);
+    if (i < len)
+        return (unsigned char)a[i] < (unsigned char)b[i] ? -1 : 1;
+
+    // One is the prefix of the other, the shorter one comes first
+    if (a_len == b_len)
+        return 0;
+    return a_len < b_len ? -1 : 1;
+}
+
+i64 cpu_bytes_find(const char* haystack, size_t haystack_len, const char* needle, size_t needle_len)
+{
+    if (needle_len == 0)
+        return 0;
+    if (needle_len > haystack_len)
+        return CPU_BYTES_NOT_FOUND;
+    if (needle_len == 1) {
+        char* p = memchr(haystack, needle[0], haystack_len);
+        return p == NULL ? CPU_BYTES_NOT_FOUND : (i64)(p - haystack);
+    }
+    return cpu_bytes_find_impl(haystack, haystack_len, needle, needle_len);
+}
+
+size_t cpu_bytes_scan_string(const char* s, size_t len)
+{
+    return cpu_bytes_scan_string_impl(s, len);
+}
+
+void cpu_bytes_dispatch()
+{
+    cpu_bytes_equal_impl = cpu_bytes_equal_scalar;
+    cpu_bytes_mismatch_impl = cpu_bytes_mismatch_scalar;
+    cpu_bytes_find_impl = cpu_bytes_find_scalar;
+    cpu_bytes_scan_string_impl = cpu_bytes_scan_string_scalar;
+
+#ifdef CPU_BYTES_SIMD
+    cpu_bytes_equal_impl = cpu_bytes_equal_sse2;
+    cpu_bytes_mismatch_impl = cpu_bytes_mismatch_sse2;
+    cpu_bytes_find_impl = cpu_bytes_find_sse2;
+    cpu_bytes_scan_string_impl = cpu_bytes_scan_string_sse2;
+
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        cpu_bytes_equal_impl = cpu_bytes_equal_avx2;
+        cpu_bytes_mismatch_impl = cpu_bytes_mismatch_avx2;
+        cpu_bytes_find_impl = cpu_bytes_find_avx2;
+        cpu_bytes_scan_string_impl = cpu_bytes_scan_string_avx2;
+    }
+#endif
+}
+
+bool cpu_bytes_equal_resolve(const char* a, const char* b, size_t len)
+{
+    cpu_bytes_dispatch();
+    return cpu_bytes_equal_impl(a, b, len);
+}
+
+size_t cpu_bytes_mismatch_resolve(const char* a, const char* b, size_t len)
+{
+    cpu_bytes_dispatch();
+    return cpu_bytes_mismatch_impl(a, b, len);
+}
+
+i64 cpu_bytes_find_resolve(const char* haystack, size_t haystack_len, const char* needle, size_t needle_len)
+{
+    cpu_bytes_dispatch();
+    return cpu_bytes_find_impl(haystack, haystack_len, needle, needle_len);
+}
+
+size_t cpu_bytes_scan_string_resolve(const char* s, size_t len)
+{
+    cpu_bytes_dispatch();
+    return cpu_bytes_scan_string_impl(s, len);
+}
+
+bool cpu_bytes_equal_scalar(const char* a, const char* b, size_t len)
+{
+    return memcmp(a, b, len) == 0;
+}
+
+size_t cpu_bytes_mismatch_scalar(const char* a, const char* b, size_t len)
+{
+    size_t i = 0;
+    while (i < len && a[i] == b[i])
+        i++;
+    return i;
+}
+
+i64 cpu_bytes_find_scalar(const char* haystack, size_t haystack_len, const char* needle, size_t needle_len)
+{
+    const char* end = haystack + haystack_len - needle_len;
+    for (const char* p = haystack; p <= end; p++) {
+        p = memchr(p, needle[0], end - p + 1);
+        if (p == NULL)
+            break;
+        if (memcmp(p + 1, needle + 1, needle_len - 1) == 0)
+            return (i64)(p - haystack);
+    }
+    return CPU_BYTES_NOT_FOUND;
+}
+
+size_t cpu_bytes_scan_string_scalar(const char* s, size_t len)
+{
+    size_t i = 0;
+    while (i < len && s[i] != '"' && s[i] != '\\' && (unsigned char)s[i] >= 0x20)
+        i++;
+    return i;
+}
+
+#ifdef CPU_BYTES_SIMD
+bool cpu_bytes_equal_sse2(const char* a, const char* b, size_t len)
+{
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i y = _mm_loadu_si128((const __m128i*)(b + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xffff)
+            return false;
+    }
+    return memcmp(a + i, b + i, len - i) == 0;
+}
+
+size_t cpu_bytes_mismatch_sse2(const char* a, const char* b, size_t len)
+{
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i y = _mm_loadu_si128((const __m128i*)(b + i));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) ^ 0xffff;
+        if (mask != 0)
+            return i + __builtin_ctz(mask);
+    }
+    return i + cpu_bytes_mismatch_scalar(a + i, b + i, len - i);
+}
+
+/*
+  The first and the last character of the needle are compared against 16
+  positions of the haystack at once, only the positions where both match
+  are compared with the whole needle.
+*/
+i64 cpu_bytes_find_sse2(const char* haystack, size_t haystack_len, const char* needle, size_t needle_len)
+{
+    __m128i first = _mm_set1_epi8(needle[0]);
+    __m128i last = _mm_set1_epi8(needle[needle_len - 1]);
+    size_t positions = haystack_len - needle_len + 1;
+
+    size_t i = 0;
+    for (; i + 16 <= positions; i += 16) {
+        __m128i block_first = _mm_loadu_si128((const __m128i*)(haystack + i));
+        __m128i block_last = _mm_loadu_si128((const __m128i*)(haystack + i + needle_len - 1));
+        unsigned mask = (unsigned)_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last))
+        );
+        while (mask != 0) {
+            unsigned bit = __builtin_ctz(mask);
+            if (memcmp(haystack + i + bit + 1, needle + 1, needle_len - 2) == 0)
+                return (i64)(i + bit);
+            mask &= mask - 1;
+        }
+    }
+
+    i64 rest = cpu_bytes_find_scalar(haystack + i, haystack_len - i, needle, needle_len);
+    return rest == CPU_BYTES_NOT_FOUND ? CPU_BYTES_NOT_FOUND : (i64)i + rest;
+}
+
+size_t cpu_bytes_scan_string_sse2(const char* s, size_t len)
+{
+    __m128i quote = _mm_set1_epi8('"');
+    __m128i backslash = _mm_set1_epi8('\\');
+    __m128i control = _mm_set1_epi8(0x1f);
+
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(s + i));
+        // A byte is a control character if max(byte, 0x1f) is 0x1f
+        __m128i special = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(x, quote), _mm_cmpeq_epi8(x, backslash)),
+            _mm_cmpeq_epi8(_mm_max_epu8(x, control), control)
+        );
+        unsigned mask = (unsigned)_mm_movemask_epi8(special);
+        if (mask != 0)
+            return i + __builtin_ctz(mask);
+    }
+    return i + cpu_bytes_scan_string_scalar(s + i, len - i);
+}
+
+__attribute__((target("avx2")))
+bool cpu_bytes_equal_avx2(const char* a, const char* b, size_t len)
+{
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i y = _mm256_loadu_si256((const __m256i*)(b + i));
+        if ((unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)) != 0xffffffffU)
+            return false;
+    }
+    return cpu_bytes_equal_sse2(a + i, b + i, len - i);
+}
+
+__attribute__((target("avx2")))
+size_t cpu_bytes_mismatch_avx2(const char* a, const char* b, size_t len)
+{
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i y = _mm256_loadu_si256((const __m256i*)(b + i));
+        unsigned mask = ~(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y));
+        if (mask != 0)
+            return i + __builtin_ctz(mask);
+    }
+    return i + cpu_bytes_mismatch_sse2(a + i, b + i, len - i);
+}
+
+__attribute__((target("avx2")))
+i64 cpu_bytes_find_avx2(const char* haystack, size_t haystack_len, const char* needle, size_t needle_len)
+{
+    __m256i first = _mm256_set1_epi8(needle[0]);
+    __m256i last = _mm256_set1_epi8(needle[needle_len - 1]);
+    size_t positions = haystack_len - needle_len + 1;
+
+    size_t i = 0;
+    for (; i + 32 <= positions; i += 32) {
+        __m256i block_first = _mm256_loadu_si256((const __m256i*)(haystack + i));
+        __m256i block_last = _mm256_loadu_si256((const __m256i*)(haystack + i + needle_len - 1));
+        unsigned mask = (unsigned)_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last))
+        );
+        while (mask != 0) {
+            unsigned bit = __builtin_ctz(mask);
+            if (memcmp(haystack + i + bit + 1, needle + 1, needle_len - 2) == 0)
+                return (i64)(i + bit);
+            mask &= mask - 1;
+        }
+    }
+
+    i64 rest = cpu_bytes_find_sse2(haystack + i, haystack_len - i, needle, needle_len);
+    return rest == CPU_BYTES_NOT_FOUND ? CPU_BYTES_NOT_FOUND : (i64)i + rest;
+}
+
+__attribute__((target("avx2")))
+size_t cpu_bytes_scan_string_avx2(const char* s, size_t len)
+{
+    __m256i quote = _mm256_set1_epi8('"');
+    __m256i backslash = _mm256_set1_epi8('\\');
+    __m256i control = _mm256_set1_epi8(0x1f);
+
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(s + i));
+        __m256i special = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(x, quote), _mm256_cmpeq_epi8(x, backslash)),
+            _mm256_cmpeq_epi8(_mm256_max_epu8(x, control), control)
+        );
+        unsigned mask = (unsigned)_mm256_movemask_epi8(special);
+        if (mask != 0)
+            return i + __builtin_ctz(mask);
+    }
+    return i + cpu_bytes_scan_string_sse2(s + i, len - i);
+}
+#endif
@@ -0,0 +1,90 @@
+/*
+ * Description: Byte string module of the Chaos Programming Language's source
+ *
+ * Copyright (c) 2019-2021 Chaos Language Development Authority <info@chaos-lang.org>
+ *
+ * License: GNU General Public License v3.0
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors: M. Mert Yildiran <me@mertyildiran.com>
+ */
+
+#ifndef BYTES_H
+#define BYTES_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "types.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#   define CPU_BYTES_SIMD
+#   include <immintrin.h>
+#endif
+
+/*
+  Runtime strings know their length, so the characters are compared and
+  searched with the lengths at hand instead of looking for null-terminators.
+  Strings of different lengths are never equal, the characters are only
+  compared once the lengths match.
+
+  On x86 the characters are compared 16 bytes (SSE2) or 32 bytes (AVX2) at
+  a time. SSE2 is always there on x86-64, AVX2 is used if the CPU supports
+  it. The implementation is picked by the first call, through the
+  cpu_bytes_*_impl pointers, which initially point to the resolvers.
+
+  cpu_bytes_scan_string finds where the plain characters of a quoted
+  string end, which is the first quote, backslash or control character.
+*/
+#define CPU_BYTES_NOT_FOUND -1
+
+typedef bool (*cpu_bytes_equal_fn)(const char* a, const char* b, size_t len);
+typedef size_t (*cpu_bytes_mismatch_fn)(const char* a, const char* b, size_t len);
+typedef i64 (*cpu_bytes_find_fn)(const char* haystack, size_t haystack_len, const char* needle, size_t needle_len);
+typedef size_t (*cpu_bytes_scan_string_fn)(const char* s, size_t len);
+
+cpu_bytes_equal_fn cpu_bytes_equal_impl;
+cpu_bytes_mismatch_fn cpu_bytes_mismatch_impl;
+cpu_bytes_find_fn cpu_bytes_find_impl;
+cpu_bytes_scan_string_fn cpu_bytes_scan_string_impl;
+
+bool cpu_bytes_equal(const char* a, size_t a_len, const char* b, size_t b_len);
+int cpu_bytes_compare(const char* a, size_t a_len, const char* b, size_t b_len);
+i64 cpu_bytes_find(const char* haystack, size_t haystack_len, const char* needle, size_t needle_len);
+size_t cpu_bytes_scan_string(const char* s, size_t len);
+
+void cpu_bytes_dispatch();
+bool cpu_bytes_equal_resolve(const char* a, const char* b, size_t len);
+size_t cpu_bytes_mismatch_resolve(const char* a, const char* b, size_t len);
+i64 cpu_bytes_find_resolve(const char* haystack, size_t haystack_len, const char* needle, size_t needle_len);
+size_t cpu_bytes_scan_string_resolve(const char* s, size_t len);
+
+bool cpu_bytes_equal_scalar(const char* a, const char* b, size_t len);
+size_t cpu_bytes_mismatch_scalar(const char* a, const char* b, size_t len);
+i64 cpu_bytes_find_scalar(const char* haystack, size_t haystack_len, const char* needle, size_t needle_len);
+size_t cpu_bytes_scan_string_scalar(const char* s, size_t len);
+
+#ifdef CPU_BYTES_SIMD
+bool cpu_bytes_equal_sse2(const char* a, const char* b, size_t len);
+size_t cpu_bytes_mismatch_sse2(const char* a, const char* b, size_t len);
+i64 cpu_bytes_find_sse2(const char* haystack, size_t haystack_len, const char* needle, size_t needle_len);
+size_t cpu_bytes_scan_string_sse2(const char* s, size_t len);
+bool cpu_bytes_equal_avx2(const char* a, const char* b, size_t len);
+size_t cpu_bytes_mismatch_avx2(const char* a, const char* b, size_t len);
+i64 cpu_bytes_find_avx2(const char* haystack, size_t haystack_len, const char* needle, size_t needle_len);
+size_t cpu_bytes_scan_string_avx2(const char* s, size_t len);
+#endif
+
+#endif
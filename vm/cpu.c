@@ -39,6 +39,11 @@ char *reg_names[] = {
 i64* ast_stack = NULL;
 i64 ast_stack_p = 0;
 
+i64 cpu_void_cell[2] = {V_VOID, 0};
+
+cpu_print_frame* cpu_print_stack = NULL;
+size_t cpu_print_stack_capacity = 0;
+
 bool temp_disable_debug = false;
 bool break_current_loop = false;
 
@@ -57,6 +62,9 @@ cpu *new_cpu(KaosIR* program, unsigned short debug_level)
 
 void free_cpu(cpu *c)
 {
+    free(cpu_print_stack);
+    cpu_print_stack = NULL;
+    cpu_print_stack_capacity = 0;
     free(c);
 }
 
@@ -93,6 +101,7 @@ void run_cpu(cpu *c)
     }
 
     _main();
+    cpu_output_flush();
 }
 
 void eat_until_hlt(cpu *c)
@@ -419,27 +428,27 @@ void execute(cpu *c)
         break;
     }
     case DYN_EQR: {
-        DYN_BINARY_COMPARISON(jit_beqr, jit_fbeqr);
+        DYN_BINARY_COMPARISON(jit_beqr, jit_fbeqr, cpu_string_differs);
         break;
     }
     case DYN_NER: {
-        DYN_BINARY_COMPARISON(jit_bner, jit_fbner);
+        DYN_BINARY_COMPARISON(jit_bner, jit_fbner, cpu_string_differs);
         break;
     }
     case DYN_GTR: {
-        DYN_BINARY_COMPARISON(jit_bgtr, jit_fbgtr);
+        DYN_BINARY_COMPARISON(jit_bgtr, jit_fbgtr, cpu_string_compare);
         break;
     }
     case DYN_LTR: {
-        DYN_BINARY_COMPARISON(jit_bltr, jit_fbltr);
+        DYN_BINARY_COMPARISON(jit_bltr, jit_fbltr, cpu_string_compare);
         break;
     }
     case DYN_GER: {
-        DYN_BINARY_COMPARISON(jit_bger, jit_fbger);
+        DYN_BINARY_COMPARISON(jit_bger, jit_fbger, cpu_string_compare);
         break;
     }
     case DYN_LER: {
-        DYN_BINARY_COMPARISON(jit_bler, jit_fbler);
+        DYN_BINARY_COMPARISON(jit_bler, jit_fbler, cpu_string_compare);
         break;
     }
     // Dynamic Logic
@@ -484,7 +493,7 @@ void execute(cpu *c)
     }
     // Dynamic Exit
     case DYN_EXIT: {
-        jit_movi(_jit, R(2), exit);
+        jit_movi(_jit, R(2), cpu_exit);
         jit_prepare(_jit);
         jit_putargr(_jit, R(1));
         jit_callr(_jit, R(2));
@@ -517,33 +526,53 @@ void execute(cpu *c)
     }
     // Dynamic Index Access
     case DYN_STR_INDEX_ACCESS: {
-        // R(1) holds the index value and the offset result should be in R(4)
-        // Jump if the index is positive
-        jit_op* positive_label = jit_bgti(_jit, JIT_FORWARD, R(1), -1);
-        // Load the string length to R(2)
-        jit_ldr(_jit, R(2), R(5), sizeof(size_t));
-        // Turn negative index into positive index
-        jit_addr(_jit, R(1), R(2), R(1));
-        // The index is positive
-        jit_patch(_jit, positive_label);
-        // offset = index * sizeof(char)
-        jit_muli(_jit, R(4), R(1), sizeof(char));
-        // offset += sizeof(size_t)
-        jit_addi(_jit, R(4), R(4), sizeof(size_t));
-        // Index offset is available in R(4)
+        // R(5) holds the string and R(1) holds the index value,
+        // the character is returned in R(1) as an inline string
+        jit_movi(_jit, R(2), cpu_string_index_access);
+        jit_prepare(_jit);
+        jit_putargr(_jit, R(5));
+        jit_putargr(_jit, R(1));
+        jit_callr(_jit, R(2));
+        jit_retval(_jit, R(1));
         break;
     }
     case DYN_COMP_ACCESS: {
+        // An unboxed element is copied into a cell in this frame, R(3) holds its address
+        int cell = jit_allocai(_jit, 2 * sizeof(i64));
+        jit_addi(_jit, R(3), R_FP, cell);
         jit_movi(_jit, R(2), cpu_composite_access);
         jit_prepare(_jit);
         jit_putargr(_jit, R(c->inst->op1->reg));
         jit_putargr(_jit, R(c->inst->op2->reg));
         jit_putargr(_jit, R(c->inst->op3->reg));
+        jit_putargr(_jit, R(3));
+        jit_callr(_jit, R(2));
+        jit_retval(_jit, R(2));
+        break;
+    }
+    case DYN_DICT_ENTRY_ACCESS: {
+        // The key-value pair and the cell of an unboxed value are in this frame, R(3) holds their address
+        int pair = jit_allocai(_jit, 4 * sizeof(i64));
+        jit_addi(_jit, R(3), R_FP, pair);
+        jit_movi(_jit, R(2), cpu_dict_entry_access);
+        jit_prepare(_jit);
+        jit_putargr(_jit, R(c->inst->op1->reg));
+        jit_putargr(_jit, R(c->inst->op2->reg));
+        jit_putargr(_jit, R(3));
         jit_callr(_jit, R(2));
         jit_retval(_jit, R(2));
         break;
     }
     // Dynamic Index Update
+    case DYN_STR_INDEX_UPDATE: {
+        jit_movi(_jit, R(2), cpu_string_index_update);
+        jit_prepare(_jit);
+        jit_putargr(_jit, R(8));
+        jit_putargr(_jit, R(13));
+        jit_putargr(_jit, R(1));
+        jit_callr(_jit, R(2));
+        break;
+    }
     case DYN_LIST_INDEX_UPDATE: {
         jit_movi(_jit, R(2), cpu_list_index_update);
         jit_prepare(_jit);
@@ -568,6 +597,88 @@ void execute(cpu *c)
         jit_retval(_jit, R(2));
         break;
     }
+    // Dynamic String Append
+    case DYN_STR_APPEND: {
+        jit_movi(_jit, R(3), cpu_string_append);
+        jit_prepare(_jit);
+        jit_putargr(_jit, R(2));
+        jit_putargr(_jit, R(1));
+        jit_callr(_jit, R(3));
+        break;
+    }
+    case DYN_STR_SHARE: {
+        // Only builders need to be told, R3 is clobbered
+        jit_andi(_jit, R(3), R(1), 7);
+        jit_op* not_builder_label = jit_bnei(_jit, JIT_FORWARD, R(3), CPU_STRING_BUILDER_TAG);
+        jit_movi(_jit, R(3), cpu_string_share);
+        jit_prepare(_jit);
+        jit_putargr(_jit, R(1));
+        jit_callr(_jit, R(3));
+        jit_patch(_jit, not_builder_label);
+        break;
+    }
+    case DYN_STR_CONCAT: {
+        jit_movi(_jit, R(3), cpu_string_concat_n);
+        jit_prepare(_jit);
+        jit_putargr(_jit, R(c->inst->op1->reg));
+        jit_putargi(_jit, c->inst->op2->value.i);
+        jit_callr(_jit, R(3));
+        jit_retval(_jit, R(c->inst->op1->reg));
+        break;
+    }
+    case DYN_STR_SLICE: {
+        jit_movi(_jit, R(3), cpu_string_slice);
+        jit_prepare(_jit);
+        jit_putargr(_jit, R(1));
+        jit_putargr(_jit, R(4));
+        jit_putargr(_jit, R(5));
+        jit_callr(_jit, R(3));
+        jit_retval(_jit, R(1));
+        break;
+    }
+    case DYN_STR_JOIN: {
+        jit_movi(_jit, R(3), cpu_string_join);
+        jit_prepare(_jit);
+        jit_putargr(_jit, R(c->inst->op1->reg));
+        jit_callr(_jit, R(3));
+        jit_retval(_jit, R(c->inst->op1->reg));
+        break;
+    }
+    case DYN_STR_SPLIT: {
+        jit_movi(_jit, R(3), cpu_string_split);
+        jit_prepare(_jit);
+        jit_putargr(_jit, R(c->inst->op1->reg));
+        jit_callr(_jit, R(3));
+        jit_retval(_jit, R(c->inst->op1->reg));
+        break;
+    }
+    case DYN_STR_REPLACE: {
+        jit_movi(_jit, R(3), cpu_string_replace);
+        jit_prepare(_jit);
+        jit_putargr(_jit, R(c->inst->op1->reg));
+        jit_callr(_jit, R(3));
+        jit_retval(_jit, R(c->inst->op1->reg));
+        break;
+    }
+    case DYN_STR_REPEAT: {
+        jit_movi(_jit, R(3), cpu_string_repeat);
+        jit_prepare(_jit);
+        jit_putargr(_jit, R(c->inst->op1->reg));
+        jit_callr(_jit, R(3));
+        jit_retval(_jit, R(c->inst->op1->reg));
+        break;
+    }
+    // Dynamic List Append
+    case DYN_LIST_APPEND: {
+        jit_movi(_jit, R(2), cpu_list_append);
+        jit_prepare(_jit);
+        jit_putargr(_jit, R(12));
+        jit_putargr(_jit, R(0));
+        jit_putargr(_jit, R(1));
+        jit_fputargr(_jit, FR(1), sizeof(double));
+        jit_callr(_jit, R(2));
+        break;
+    }
     // Dynamic Type Conversion
     case DYN_BOOL_TO_STR: {
         jit_movi(_jit, R(2), cpu_boolean_to_string);
@@ -720,45 +831,50 @@ void cpu_print(i64 r0, i64 r1, f64 fr1, i64 nl, i64 pretty)
         cpu_print_string(r1, false);
         break;
     case V_LIST:
-        cpu_print_list(r1, pretty, 0);
-        break;
     case V_DICT:
-        cpu_print_dict(r1, pretty, 0);
+        cpu_print_composite(r1, r0, pretty);
         break;
     default:
         break;
     }
 
     if (nl != 0)
-        printf("\n");
+        cpu_output_char('\n');
 }
 
 void cpu_print_bool(i64 i)
 {
-    printf("%s", i ? "true" : "false");
+    if (i)
+        cpu_output_write("true", 4);
+    else
+        cpu_output_write("false", 5);
 }
 
 void cpu_print_int(i64 i)
 {
-    printf("%lld", i);
+    char* buf = cpu_output_reserve(CPU_FORMAT_MAX);
+    cpu_output_commit(cpu_format_int(i, buf));
 }
 
 void cpu_print_float(f64 f)
 {
-    printf("%lg", f);
+    char* buf = cpu_output_reserve(CPU_FORMAT_MAX);
+    cpu_output_commit(cpu_format_float(f, buf));
 }
 
 void cpu_print_string(i64 addr, bool quoted)
 {
-    addr += sizeof(size_t);
-    char *s = (char*)addr;
+    // Escape sequences are resolved at compile time, write the characters as they are
+    char buf[CPU_SSO_MAX + 1];
+    char *s = cpu_string_chars(addr, buf);
     if (quoted)
-        printf("'%s'", escape_the_sequences_in_string_literal(s));
-    else
-        printf("%s", escape_the_sequences_in_string_literal(s));
+        cpu_output_char('\'');
+    cpu_output_write(s, cpu_string_len(addr));
+    if (quoted)
+        cpu_output_char('\'');
 }
 
-void cpu_print_flex(i64 addr, i64 pretty, unsigned long iter)
+void cpu_print_flex(i64 addr)
 {
     i64 type = *(i64*)addr;
     addr += sizeof(long long);
@@ -778,155 +894,146 @@ void cpu_print_flex(i64 addr, i64 pretty, unsigned long iter)
         cpu_print_string(val_i, true);
         break;
     case V_LIST:
-        cpu_print_list(*(i64*)addr, pretty, iter);
-        break;
     case V_DICT:
-        cpu_print_dict(*(i64*)addr, pretty, iter);
+        cpu_print_composite(val_i, type, false);
         break;
     default:
         break;
     }
 }
 
-void cpu_print_list(i64 addr, i64 pretty, unsigned long iter)
+void cpu_print_composite(i64 addr, i64 type, i64 pretty)
 {
-    size_t* len = (size_t*)addr;
-    addr += sizeof(size_t);
-    printf("[");
-    if (pretty)
-        printf("\n");
-    iter++;
-    for (size_t i = 0; i < *len; i++) {
-        if (pretty)
-            for (unsigned long j = 0; j < iter; j++) {
-                printf(__KAOS_TAB__);
+    size_t depth = 0;
+    cpu_print_frame frame = {addr, type, 0, 0};
+    i64 cell[2];
+    cpu_print_open(type, pretty);
+
+    for (;;) {
+        // Find the next element of the innermost container
+        i64 key = 0;
+        i64 value = 0;
+        if (frame.type == V_LIST) {
+            cpu_list* list = (cpu_list*)frame.addr;
+            if (frame.i < list->size)
+                value = cpu_list_item(list, frame.i++, cell);
+        } else {
+            cpu_dict* dict = (cpu_dict*)frame.addr;
+            // Skip the tombstones
+            while (frame.i < dict->used && dict->entries[frame.i] == 0)
+                frame.i++;
+            if (frame.i < dict->used) {
+                i64 key_value_pair = dict->entries[frame.i++];
+                key = *(i64*)key_value_pair;
+                value = cpu_dict_value(dict, key_value_pair, cell);
             }
-        cpu_print_flex(*(i64*)addr, pretty, iter);
-        addr += sizeof(long long);
-        if (i + 1 != *len) {
+        }
+
+        if (value == 0) {
+            // The container is done, close it and continue with its parent
+            if (pretty) {
+                cpu_output_char('\n');
+                cpu_output_indent(depth);
+            }
+            cpu_output_char(frame.type == V_LIST ? ']' : '}');
+            if (depth == 0)
+                return;
+            frame = cpu_print_stack[--depth];
+            continue;
+        }
+
+        if (frame.printed++ != 0) {
             if (pretty)
-                printf(",\n");
+                cpu_output_write(",\n", 2);
             else
-                printf(", ");
+                cpu_output_write(", ", 2);
         }
-    }
-    if (pretty)
-        printf("\n");
-    if (pretty) {
-        for (unsigned long j = 0; j < (iter - 1); j++) {
-            printf(__KAOS_TAB__);
+        if (pretty)
+            cpu_output_indent(depth + 1);
+        if (key != 0) {
+            cpu_print_flex(key);
+            cpu_output_write(": ", 2);
+        }
+
+        i64 value_type = *(i64*)value;
+        if (value_type != V_LIST && value_type != V_DICT) {
+            cpu_print_flex(value);
+            continue;
+        }
+
+        // Descend into the nested container
+        if (depth == cpu_print_stack_capacity) {
+            cpu_print_stack_capacity = cpu_print_stack_capacity == 0 ? 16 : cpu_print_stack_capacity * 2;
+            cpu_print_stack = realloc(cpu_print_stack, cpu_print_stack_capacity * sizeof(cpu_print_frame));
         }
+        cpu_print_stack[depth++] = frame;
+        frame.addr = *(i64*)(value + sizeof(i64));
+        frame.type = value_type;
+        frame.i = 0;
+        frame.printed = 0;
+        cpu_print_open(value_type, pretty);
     }
-    printf("]");
 }
 
-void cpu_print_dict(i64 addr, i64 pretty, unsigned long iter)
+void cpu_print_open(i64 type, i64 pretty)
 {
-    size_t* len = (size_t*)addr;
-    addr += sizeof(size_t);
-    printf("{");
+    cpu_output_char(type == V_LIST ? '[' : '{');
     if (pretty)
-        printf("\n");
-    iter++;
-    for (size_t i = 0; i < *len; i++) {
-        if (pretty)
-            for (unsigned long j = 0; j < iter; j++) {
-                printf(__KAOS_TAB__);
-            }
-        i64 _addr = *(i64*)addr;
-        addr += sizeof(long long);
-        i64 key = *(i64*)_addr;
-        _addr += sizeof(long long);
-        i64 value = *(i64*)_addr;
-        cpu_print_flex(key, pretty, iter);
-        printf(": ");
-        cpu_print_flex(value, pretty, iter);
-        if (i + 1 != *len) {
-            if (pretty)
-                printf(",\n");
-            else
-                printf(", ");
-        }
-    }
-    if (pretty)
-        printf("\n");
-    if (pretty) {
-        for (unsigned long j = 0; j < (iter - 1); j++) {
-            printf(__KAOS_TAB__);
-        }
-    }
-    printf("}");
+        cpu_output_char('\n');
 }
 
-i64 cpu_composite_access(i64 addr, i64 type, i64 val)
+i64 cpu_composite_access(i64 addr, i64 type, i64 val, i64 cell)
 {
     if (type == V_LIST)
-        return cpu_list_index_access(addr, val);
+        return cpu_list_index_access(addr, val, (i64*)cell);
     else
-        return cpu_dict_key_search(addr, val);
+        return cpu_dict_key_search(addr, val, (i64*)cell);
 }
 
-i64 cpu_list_index_access(i64 addr, i64 i)
+i64 cpu_list_index_access(i64 addr, i64 i, i64* cell)
 {
-    size_t* len = (size_t*)addr;
-    addr += sizeof(size_t);
+    cpu_list* list = (cpu_list*)addr;
     if (i < 0)
-        i = *len + i;
-    // printf("len: %lu\n", *len);
-    // printf("i: %lld\n", i);
+        i = list->size + i;
 
-    addr += sizeof(long long) * i;
-    i64 _addr = *(i64*)addr;
-    // i64 type = *(i64*)_addr;
-    // _addr += sizeof(long long);
-    // i64 val_i = *(i64*)_addr;
-    // f64 val_f = *(f64*)_addr;
-    // printf("type: %lld\n", type);
-    // printf("val_i: %lld\n", val_i);
-    // printf("val_f: %f\n", val_f);
+    // TODO: throw error
+    if (i < 0 || (size_t)i >= list->size)
+        return (i64)cpu_void_cell;
 
-    return _addr;
+    return cpu_list_item(list, i, cell);
 }
 
-i64 cpu_dict_key_search(i64 addr, i64 search_key_addr)
+i64 cpu_dict_key_search(i64 addr, i64 search_key_addr, i64* cell)
 {
-    size_t* len = (size_t*)addr;
-    addr += sizeof(size_t);
-
-    search_key_addr += sizeof(size_t);
-    char* search_key = (char*)search_key_addr;
-
-    for (size_t i = 0; i < *len; i++) {
-        i64 key_value_pair = *(i64*)addr;
-        addr += sizeof(i64);
-
-        i64 key_ref = *(i64*)key_value_pair;
-        key_value_pair += sizeof(i64);
-        i64 value_ref = *(i64*)key_value_pair;
-
-        key_ref += sizeof(i64);
-        i64 key_addr = *(i64*)key_ref;
-        key_addr += sizeof(size_t);
-        char* key = (char*)key_addr;
-
-        if (strcmp(search_key, key) == 0)
-            return value_ref;
-    }
+    cpu_dict* dict = (cpu_dict*)addr;
+    i64 pos = cpu_dict_lookup(dict, search_key_addr, NULL);
 
     // TODO: throw error
+    if (pos < 0)
+        return (i64)cpu_void_cell;
 
-    return 0;
+    return cpu_dict_value(dict, dict->entries[pos], cell);
 }
 
 void cpu_list_index_update(i64 addr, i64 i, i64 r0, i64 r1, f64 fr1)
 {
-    size_t* len = (size_t*)addr;
-    addr += sizeof(size_t);
+    cpu_list* list = (cpu_list*)addr;
     if (i < 0)
-        i = *len + i;
+        i = list->size + i;
+
+    // TODO: throw error
+    if (i < 0 || (size_t)i >= list->size)
+        return;
 
-    addr += sizeof(long long) * i;
-    i64 _addr = *(i64*)addr;
+    if (list->value_type != V_ANY && list->value_type != r0)
+        cpu_list_box(list);
+
+    if (list->value_type != V_ANY) {
+        *cpu_list_slot(list, i) = cpu_value_word(r0, r1, fr1);
+        return;
+    }
+
+    i64 _addr = *cpu_list_slot(list, i);
     *(i64*)_addr = r0;
     _addr += sizeof(long long);
     if (r0 == V_FLOAT)
@@ -935,39 +1042,106 @@ void cpu_list_index_update(i64 addr, i64 i, i64 r0, i64 r1, f64 fr1)
         *(i64*)_addr = r1;
 }
 
-void cpu_dict_key_update(i64 addr, i64 search_key_addr, i64 r0, i64 r1, f64 fr1)
+i64* cpu_list_slot(cpu_list* list, size_t i)
 {
-    size_t* len = (size_t*)addr;
-    addr += sizeof(size_t);
+    i += list->head;
+    if (i >= list->capacity)
+        i -= list->capacity;
+    return &list->items[i];
+}
 
-    search_key_addr += sizeof(size_t);
-    char* search_key = (char*)search_key_addr;
+i64 cpu_list_item(cpu_list* list, size_t i, i64* cell)
+{
+    i64 item = *cpu_list_slot(list, i);
+    if (list->value_type == V_ANY)
+        return item;
+
+    // Unboxed elements are copied into the caller's cell along with the list's value type
+    cell[0] = list->value_type;
+    cell[1] = item;
+    return (i64)cell;
+}
 
-    for (size_t i = 0; i < *len; i++) {
-        i64 key_value_pair = *(i64*)addr;
-        addr += sizeof(i64);
+void cpu_list_box(cpu_list* list)
+{
+    for (size_t i = 0; i < list->size; i++) {
+        i64* slot = cpu_list_slot(list, i);
+        *slot = cpu_new_common(list->value_type, *slot);
+    }
+    list->value_type = V_ANY;
+}
 
-        i64 key_ref = *(i64*)key_value_pair;
-        key_value_pair += sizeof(i64);
-        i64 value_ref = *(i64*)key_value_pair;
+void cpu_list_grow(cpu_list* list)
+{
+    size_t capacity = list->capacity * 2;
+    if (capacity < CPU_LIST_MIN_CAPACITY)
+        capacity = CPU_LIST_MIN_CAPACITY;
+
+    // Unwrap the ring while copying so that the head starts from zero again
+    i64* items = (i64*)malloc(capacity * sizeof(i64));
+    for (size_t i = 0; i < list->size; i++)
+        items[i] = *cpu_list_slot(list, i);
+
+    // The initial items live in the same block with the header
+    if (list->items != (i64*)(list + 1))
+        free(list->items);
+
+    list->items = items;
+    list->capacity = capacity;
+    list->head = 0;
+}
 
-        key_ref += sizeof(i64);
-        i64 key_addr = *(i64*)key_ref;
-        key_addr += sizeof(size_t);
-        char* key = (char*)key_addr;
-
-        if (strcmp(search_key, key) == 0) {
-            *(i64*)value_ref = r0;
-            value_ref += sizeof(i64);
-            if (r0 == V_FLOAT)
-                *(f64*)value_ref = fr1;
-            else
-                *(i64*)value_ref = r1;
-            return;
-        }
+void cpu_list_append(i64 addr, i64 r0, i64 r1, f64 fr1)
+{
+    cpu_list* list = (cpu_list*)addr;
+    if (list->size == list->capacity)
+        cpu_list_grow(list);
+
+    // An empty list takes the type of its first element
+    if (list->size == 0 && r0 <= V_STRING)
+        list->value_type = r0;
+    else if (list->value_type != V_ANY && list->value_type != r0)
+        cpu_list_box(list);
+
+    list->size += 1;
+    *cpu_list_slot(list, list->size - 1) = cpu_new_item(list->value_type, r0, r1, fr1);
+}
+
+void cpu_dict_key_update(i64 addr, i64 search_key_addr, i64 r0, i64 r1, f64 fr1)
+{
+    cpu_dict* dict = (cpu_dict*)addr;
+    i64 pos = cpu_dict_lookup(dict, search_key_addr, NULL);
+
+    // An empty dictionary takes the type of its first value
+    if (dict->size == 0 && r0 <= V_STRING)
+        dict->value_type = r0;
+    else if (dict->value_type != V_ANY && dict->value_type != r0)
+        cpu_dict_box(dict);
+
+    // A new key, append it to the end to keep the insertion order
+    if (pos < 0) {
+        i64 key_value_pair = (i64)malloc(2 * sizeof(i64));
+        i64* p = (i64*)key_value_pair;
+        p[0] = cpu_new_common(V_STRING, intern_string_ref(search_key_addr));
+        p[1] = cpu_new_item(dict->value_type, r0, r1, fr1);
+        cpu_dict_insert(dict, key_value_pair);
+        return;
     }
 
-    // TODO: throw error
+    i64 key_value_pair = dict->entries[pos];
+    key_value_pair += sizeof(i64);
+    if (dict->value_type != V_ANY) {
+        *(i64*)key_value_pair = cpu_value_word(r0, r1, fr1);
+        return;
+    }
+    i64 value_ref = *(i64*)key_value_pair;
+
+    *(i64*)value_ref = r0;
+    value_ref += sizeof(i64);
+    if (r0 == V_FLOAT)
+        *(f64*)value_ref = fr1;
+    else
+        *(i64*)value_ref = r1;
 }
 
 i64 cpu_new_common(i64 type, i64 val)
@@ -982,59 +1156,83 @@ i64 cpu_new_common(i64 type, i64 val)
     return orig_p;
 }
 
+i64 cpu_new_value(i64 type, i64 val)
+{
+    i64 p;
+    switch (type) {
+    case V_STRING:
+        return cpu_new_string(val);
+    case V_LIST:
+        p = (i64)malloc(2 * sizeof(i64));
+        cpu_new_list(val, p);
+        return p;
+    case V_DICT:
+        p = (i64)malloc(2 * sizeof(i64));
+        cpu_new_dict(val, p);
+        return p;
+    default:
+        return cpu_new_common(type, val);
+    }
+}
+
+i64 cpu_new_item(i64 value_type, i64 r0, i64 r1, f64 fr1)
+{
+    // Containers own a copy of the value, a boxed one or the value itself
+    i64 val = cpu_value_word(r0, r1, fr1);
+    if (value_type == V_ANY)
+        return cpu_new_value(r0, val);
+    if (r0 == V_STRING)
+        return cpu_string_copy(val);
+    return val;
+}
+
+i64 cpu_value_word(i64 r0, i64 r1, f64 fr1)
+{
+    if (r0 != V_FLOAT)
+        return r1;
+
+    i64 val;
+    memcpy(&val, &fr1, sizeof(f64));
+    return val;
+}
+
 i64 cpu_new_string(i64 addr)
 {
-    size_t* len = (size_t*)addr;
-    addr += sizeof(size_t);
-    char* s = (char*)addr;
-    i64 new_str = (i64)malloc((*len + 1) * sizeof(char) + sizeof(size_t));
-    i64 orig_new_str = new_str;
-    size_t* new_len = (size_t*)new_str;
-    *new_len = *len;
-    new_str += sizeof(size_t);
-    char* new_s = (char*)new_str;
-    memcpy(new_s, s, (*len + 1) * sizeof(char));
-    return cpu_new_common(V_STRING, orig_new_str);
+    return cpu_new_common(V_STRING, cpu_string_copy(addr));
+}
+
+i64 cpu_string_copy(i64 ref)
+{
+    // Inline strings are copied along with the value word,
+    // interned strings and views are immutable so they can be shared
+    if (CPU_STRING_IS_INLINE(ref) || CPU_STRING_IS_INTERNED(ref) || CPU_STRING_IS_VIEW(ref))
+        return ref;
+
+    return cpu_string_make(cpu_string_chars(ref, NULL), cpu_string_len(ref));
 }
 
 void cpu_new_list(i64 addr, i64 new_addr)
 {
-    size_t* len = (size_t*)addr;
-    addr += sizeof(size_t);
-    i64 ref_addr = (i64)malloc(sizeof(i64) * *len + sizeof(size_t));
-    i64 orig_ref_addr = ref_addr;
-    size_t* new_len = (size_t*)ref_addr;
-    *new_len = *len;
-    ref_addr += sizeof(size_t);
-
-    for (size_t i = 0; i < *len; i++) {
-        i64 _addr = *(i64*)addr;
-        i64 type = *(i64*)_addr;
-        _addr += sizeof(i64);
-        i64* p = (i64*)ref_addr;
-        switch (type) {
-        case V_BOOL:
-        case V_INT:
-        case V_FLOAT:
-            *p = cpu_new_common(type, *(i64*)_addr);
-            break;
-        case V_STRING:
-            *p = cpu_new_string(*(i64*)_addr);
-            break;
-        case V_LIST:
-            *p = (i64)malloc(2 * sizeof(i64));
-            cpu_new_list(*(i64*)_addr, *p);
-            break;
-        case V_DICT:
-            *p = (i64)malloc(2 * sizeof(i64));
-            cpu_new_dict(*(i64*)_addr, *p);
-            break;
-        default:
-            break;
-        }
+    cpu_list* list = (cpu_list*)addr;
 
-        addr += sizeof(i64);
-        ref_addr += sizeof(i64);
+    // The copy is unwrapped, its items follow the header
+    i64 ref_addr = (i64)malloc(sizeof(cpu_list) + list->size * sizeof(i64));
+    i64 orig_ref_addr = ref_addr;
+    cpu_list* new_list = (cpu_list*)ref_addr;
+    new_list->size = list->size;
+    new_list->capacity = list->size;
+    new_list->head = 0;
+    new_list->items = (i64*)(new_list + 1);
+    new_list->value_type = list->value_type;
+
+    for (size_t i = 0; i < list->size; i++) {
+        i64 item = *cpu_list_slot(list, i);
+        if (list->value_type == V_STRING)
+            new_list->items[i] = cpu_string_copy(item);
+        else if (list->value_type != V_ANY)
+            new_list->items[i] = item;
+        else
+            new_list->items[i] = cpu_new_value(*(i64*)item, *(i64*)(item + sizeof(i64)));
     }
 
     i64* p1 = (i64*)new_addr;
@@ -1046,16 +1244,24 @@ void cpu_new_list(i64 addr, i64 new_addr)
 
 void cpu_new_dict(i64 addr, i64 new_addr)
 {
-    size_t* len = (size_t*)addr;
-    addr += sizeof(size_t);
-    i64 ref_addr = (i64)malloc(sizeof(i64) * *len + sizeof(size_t));
-    i64 orig_ref_addr = ref_addr;
-    size_t* new_len = (size_t*)ref_addr;
-    *new_len = *len;
-    ref_addr += sizeof(size_t);
+    cpu_dict* dict = (cpu_dict*)addr;
 
-    for (size_t i = 0; i < *len; i++) {
-        i64 key_value_pair = *(i64*)addr;
+    // The copy is compacted, its entries follow the header
+    i64 ref_addr = (i64)malloc(sizeof(cpu_dict) + sizeof(i64) * dict->size);
+    i64 orig_ref_addr = ref_addr;
+    cpu_dict* new_dict = (cpu_dict*)ref_addr;
+    new_dict->size = dict->size;
+    new_dict->used = dict->size;
+    new_dict->capacity = dict->size;
+    new_dict->entries = (i64*)(ref_addr + sizeof(cpu_dict));
+    new_dict->index = NULL;
+    new_dict->value_type = dict->value_type;
+    ref_addr += sizeof(cpu_dict);
+
+    for (size_t i = 0; i < dict->used; i++) {
+        i64 key_value_pair = dict->entries[i];
+        if (key_value_pair == 0)
+            continue;
 
         i64 key_ref = *(i64*)key_value_pair;
         key_value_pair += sizeof(i64);
@@ -1067,35 +1273,17 @@ void cpu_new_dict(i64 addr, i64 new_addr)
         *p = new_key_value_pair;
 
         i64* new_key = (i64*)new_key_value_pair;
-        *new_key = cpu_new_string(*(i64*)key_ref);
+        *new_key = cpu_new_common(V_STRING, intern_string_ref(*(i64*)key_ref));
         new_key_value_pair += sizeof(i64);
         i64* new_value = (i64*)new_key_value_pair;
 
-        i64 type = *(i64*)value_ref;
-        value_ref += sizeof(i64);
-
-        switch (type) {
-        case V_BOOL:
-        case V_INT:
-        case V_FLOAT:
-            *new_value = cpu_new_common(type, *(i64*)value_ref);
-            break;
-        case V_STRING:
-            *new_value = cpu_new_string(*(i64*)value_ref);
-            break;
-        case V_LIST:
-            *new_value = (i64)malloc(2 * sizeof(i64));
-            cpu_new_list(*(i64*)value_ref, *new_value);
-            break;
-        case V_DICT:
-            *new_value = (i64)malloc(2 * sizeof(i64));
-            cpu_new_dict(*(i64*)value_ref, *new_value);
-            break;
-        default:
-            break;
-        }
+        if (dict->value_type == V_STRING)
+            *new_value = cpu_string_copy(value_ref);
+        else if (dict->value_type != V_ANY)
+            *new_value = value_ref;
+        else
+            *new_value = cpu_new_value(*(i64*)value_ref, *(i64*)(value_ref + sizeof(i64)));
 
-        addr += sizeof(i64);
         ref_addr += sizeof(i64);
     }
 
@@ -1106,68 +1294,448 @@ void cpu_new_dict(i64 addr, i64 new_addr)
     *p2 = orig_ref_addr;
 }
 
-void cpu_delete_string_index(i64 i, i64 addr)
+void cpu_delete_string_index(i64 i, i64 cell)
 {
-    size_t* len = (size_t*)addr;
+    cell += sizeof(i64);
+    i64 addr = *(i64*)cell;
+    size_t len = cpu_string_len(addr);
+    i = cpu_string_index(i, len);
+
+    if (CPU_STRING_IS_INLINE(addr)) {
+        char buf[CPU_SSO_MAX + 1];
+        char *s = cpu_string_chars(addr, buf);
+        memmove(&s[i], &s[i + 1], (len - i) * sizeof(char));
+        *(i64*)cell = cpu_string_pack(s, len - 1);
+        return;
+    }
+
+    // The string may be shared, only a builder owned by the cell is written to
+    cpu_string_builder* builder = cpu_string_own(cell, 0);
+    memmove(&builder->chars[i], &builder->chars[i + 1], (builder->size - i) * sizeof(char));
+    builder->size -= 1;
+}
+
+size_t cpu_string_len(i64 ref)
+{
+    if (CPU_STRING_IS_INLINE(ref))
+        return (size_t)((ref & 0xff) >> 1);
+    return *(size_t*)CPU_STRING_PTR(ref);
+}
+
+char* cpu_string_chars(i64 ref, char* buf)
+{
+    if (CPU_STRING_IS_VIEW(ref))
+        return ((cpu_string_view*)CPU_STRING_PTR(ref))->chars;
+    if (!CPU_STRING_IS_INLINE(ref))
+        return (char*)(CPU_STRING_PTR(ref) + sizeof(size_t));
+
+    // Unpack the inline string into the caller's buffer
+    size_t len = cpu_string_len(ref);
+    for (size_t i = 0; i < len; i++)
+        buf[i] = (char)(((u64)ref >> ((i + 1) * 8)) & 0xff);
+    buf[len] = '\0';
+    return buf;
+}
+
+i64 cpu_string_pack(char* s, size_t len)
+{
+    u64 ref = ((u64)len << 1) | 1;
+    for (size_t i = 0; i < len; i++)
+        ref |= (u64)(byte)s[i] << ((i + 1) * 8);
+    return (i64)ref;
+}
+
+i64 cpu_string_make(char* s, size_t len)
+{
+    if (len <= CPU_SSO_MAX)
+        return cpu_string_pack(s, len);
+
+    i64 p = (i64)malloc((len + 1) * sizeof(char) + sizeof(size_t));
+    size_t* p_t = (size_t*)p;
+    *p_t = len;
+    char *p_s = (char*)(p + sizeof(size_t));
+    memcpy(p_s, s, len * sizeof(char));
+    p_s[len] = '\0';
+    return p;
+}
+
+bool cpu_string_equals(i64 ref1, i64 ref2)
+{
+    if (ref1 == ref2)
+        return true;
+
+    // Inline and interned strings are unique per content
+    bool canonical1 = CPU_STRING_IS_INLINE(ref1) || CPU_STRING_IS_INTERNED(ref1);
+    bool canonical2 = CPU_STRING_IS_INLINE(ref2) || CPU_STRING_IS_INTERNED(ref2);
+    if (canonical1 && canonical2)
+        return false;
+
+    size_t len1 = cpu_string_len(ref1);
+    size_t len2 = cpu_string_len(ref2);
+    if (len1 != len2)
+        return false;
+
+    char buf1[CPU_SSO_MAX + 1];
+    char buf2[CPU_SSO_MAX + 1];
+    return cpu_bytes_equal(cpu_string_chars(ref1, buf1), len1, cpu_string_chars(ref2, buf2), len2);
+}
+
+i64 cpu_string_differs(i64 ref1, i64 ref2)
+{
+    return cpu_string_equals(ref1, ref2) ? 0 : 1;
+}
+
+i64 cpu_string_compare(i64 ref1, i64 ref2)
+{
+    if (ref1 == ref2)
+        return 0;
+
+    char buf1[CPU_SSO_MAX + 1];
+    char buf2[CPU_SSO_MAX + 1];
+    return cpu_bytes_compare(
+        cpu_string_chars(ref1, buf1),
+        cpu_string_len(ref1),
+        cpu_string_chars(ref2, buf2),
+        cpu_string_len(ref2)
+    );
+}
+
+i64 cpu_string_index(i64 i, size_t len)
+{
+    // The index is checked before any buffer is touched, inline strings are unpacked onto the stack
     if (i < 0)
-        i = *len + i;
+        i = (i64)len + i;
+    if (i < 0 || (size_t)i >= len)
+        throw_error(E_INDEX_OUT_OF_RANGE_STRING, NULL, NULL, i);
+    return i;
+}
 
-    addr += sizeof(size_t);
-    char *s = (char*)addr;
-    memmove(&s[i], &s[i + 1], (*len - i) * sizeof(char));
-    *len -= 1;
+i64 cpu_string_index_access(i64 ref, i64 i)
+{
+    char buf[CPU_SSO_MAX + 1];
+    i = cpu_string_index(i, cpu_string_len(ref));
+    char *s = cpu_string_chars(ref, buf);
+    return cpu_string_pack(&s[i], 1);
+}
+
+void cpu_string_index_update(i64 cell, i64 i, i64 char_ref)
+{
+    char char_buf[CPU_SSO_MAX + 1];
+    char c = cpu_string_chars(char_ref, char_buf)[0];
+
+    cell += sizeof(i64);
+    i64 ref = *(i64*)cell;
+    size_t len = cpu_string_len(ref);
+    i = cpu_string_index(i, len);
+
+    if (CPU_STRING_IS_INLINE(ref)) {
+        // Inline strings live in the cell itself, repack and store them back
+        char buf[CPU_SSO_MAX + 1];
+        char *s = cpu_string_chars(ref, buf);
+        s[i] = c;
+        *(i64*)cell = cpu_string_pack(s, len);
+        return;
+    }
+
+    // The string may be shared, only a builder owned by the cell is written to
+    cpu_string_builder* builder = cpu_string_own(cell, 0);
+    builder->chars[i] = c;
+}
+
+void cpu_string_append(i64 cell, i64 ref)
+{
+    cell += sizeof(i64);
+    char buf[CPU_SSO_MAX + 1];
+    size_t len2 = cpu_string_len(ref);
+    char *s2 = cpu_string_chars(ref, buf);
+
+    cpu_string_builder* builder = cpu_string_own(cell, len2);
+    memcpy(builder->chars + builder->size, s2, len2 * sizeof(char));
+    builder->size += len2;
+    builder->chars[builder->size] = '\0';
+}
+
+cpu_string_builder* cpu_string_own(i64 cell, size_t extra)
+{
+    i64 ref = *(i64*)cell;
+    size_t len = cpu_string_len(ref);
+
+    cpu_string_builder* builder = NULL;
+    if (CPU_STRING_IS_BUILDER(ref)) {
+        builder = (cpu_string_builder*)(CPU_STRING_PTR(ref) - offsetof(cpu_string_builder, size));
+        if (builder->owner != cell)
+            builder = NULL;
+    }
+
+    if (builder != NULL && len + extra > builder->capacity) {
+        // Only the owner holds the reference, the builder can be moved
+        builder->capacity = 2 * (len + extra);
+        builder = realloc(builder, sizeof(cpu_string_builder) + (builder->capacity + 1) * sizeof(char));
+    } else if (builder == NULL) {
+        // Start a new builder that is owned by the cell
+        size_t capacity = 2 * (len + extra);
+        if (capacity < CPU_STRING_BUILDER_MIN_CAPACITY)
+            capacity = CPU_STRING_BUILDER_MIN_CAPACITY;
+        char buf[CPU_SSO_MAX + 1];
+        char *s = cpu_string_chars(ref, buf);
+        builder = malloc(sizeof(cpu_string_builder) + (capacity + 1) * sizeof(char));
+        builder->owner = cell;
+        builder->capacity = capacity;
+        builder->size = len;
+        memcpy(builder->chars, s, len * sizeof(char));
+        builder->chars[len] = '\0';
+    }
+
+    *(i64*)cell = (i64)&builder->size | CPU_STRING_BUILDER_TAG;
+    return builder;
+}
+
+i64 cpu_string_slice(i64 ref, i64 low, i64 high)
+{
+    i64 len = (i64)cpu_string_len(ref);
+    if (low < 0)
+        low = len + low;
+    if (high < 0)
+        high = len + high;
+    if (low < 0)
+        low = 0;
+    if (high > len)
+        high = len;
+    if (low > high)
+        low = high;
+
+    char buf[CPU_SSO_MAX + 1];
+    char *s = cpu_string_chars(ref, buf);
+    size_t size = (size_t)(high - low);
+    if (size <= CPU_SSO_MAX)
+        return cpu_string_pack(s + low, size);
+
+    // The characters of a view are already the original ones
+    cpu_string_view* view = malloc(sizeof(cpu_string_view));
+    view->size = size;
+    view->chars = s + low;
+    return (i64)view | CPU_STRING_VIEW_TAG;
+}
+
+void cpu_string_share(i64 ref)
+{
+    if (!CPU_STRING_IS_BUILDER(ref))
+        return;
+
+    cpu_string_builder* builder = (cpu_string_builder*)(CPU_STRING_PTR(ref) - offsetof(cpu_string_builder, size));
+    builder->owner = 0;
 }
 
 void cpu_delete_list_index(i64 i, i64 addr)
 {
-    size_t* len = (size_t*)addr;
+    cpu_list* list = (cpu_list*)addr;
     if (i < 0)
-        i = *len + i;
+        i = list->size + i;
 
-    addr += sizeof(size_t);
-    i64* arr = (i64*)addr;
-    memmove(&arr[i], &arr[i + 1], (*len - (size_t)i) * sizeof(i64));
-    *len -= 1;
+    if (i < 0 || (size_t)i >= list->size)
+        return;
+
+    // Close the gap from whichever end is closer, popping either end is O(1)
+    if ((size_t)i < list->size / 2) {
+        for (size_t j = i; j > 0; j--)
+            *cpu_list_slot(list, j) = *cpu_list_slot(list, j - 1);
+        list->head = list->head + 1 == list->capacity ? 0 : list->head + 1;
+    } else {
+        for (size_t j = i; j + 1 < list->size; j++)
+            *cpu_list_slot(list, j) = *cpu_list_slot(list, j + 1);
+    }
+    list->size -= 1;
 }
 
 void cpu_delete_dict_key(i64 search_key_addr, i64 addr)
 {
-    size_t* len = (size_t*)addr;
-    addr += sizeof(size_t);
-    i64* arr = (i64*)addr;
+    cpu_dict* dict = (cpu_dict*)addr;
+    i64 slot = -1;
+    i64 pos = cpu_dict_lookup(dict, search_key_addr, &slot);
+    if (pos < 0)
+        return;
 
-    search_key_addr += sizeof(size_t);
-    char* search_key = (char*)search_key_addr;
+    // Leave a tombstone behind to keep the insertion order
+    dict->entries[pos] = 0;
+    if (slot >= 0)
+        dict->index[slot + 1] = CPU_DICT_SLOT_DELETED;
+    dict->size -= 1;
 
-    for (size_t i = 0; i < *len; i++) {
-        i64 key_value_pair = *(i64*)addr;
-        addr += sizeof(i64);
+    if (dict->used - dict->size > dict->used / 2)
+        cpu_dict_compact(dict);
+}
 
-        i64 key_ref = *(i64*)key_value_pair;
-        key_value_pair += sizeof(i64);
+i64 cpu_dict_pair_key(i64 key_value_pair)
+{
+    i64 key_ref = *(i64*)key_value_pair;
+    key_ref += sizeof(i64);
+    return *(i64*)key_ref;
+}
 
-        key_ref += sizeof(i64);
-        i64 key_addr = *(i64*)key_ref;
-        key_addr += sizeof(size_t);
-        char* key = (char*)key_addr;
-
-        if (strcmp(search_key, key) == 0) {
-            memmove(&arr[i], &arr[i + 1], (*len - (size_t)i) * sizeof(i64));
-            *len -= 1;
-            return;
+i64 cpu_dict_lookup(cpu_dict* dict, i64 search_key_addr, i64* slot)
+{
+    if (dict->index == NULL && dict->used > CPU_DICT_INDEX_THRESHOLD)
+        cpu_dict_build_index(dict);
+
+    // Small dictionaries are scanned linearly
+    if (dict->index == NULL) {
+        for (size_t i = 0; i < dict->used; i++) {
+            i64 key_value_pair = dict->entries[i];
+            if (key_value_pair != 0 && cpu_string_equals(search_key_addr, cpu_dict_pair_key(key_value_pair)))
+                return i;
         }
+        return -1;
+    }
+
+    u64 mask = (u64)dict->index[0] - 1;
+    i64* slots = &dict->index[1];
+    for (u64 i = intern_hash(search_key_addr) & mask;; i = (i + 1) & mask) {
+        i64 pos = slots[i];
+        if (pos == CPU_DICT_SLOT_EMPTY)
+            return -1;
+        if (pos == CPU_DICT_SLOT_DELETED)
+            continue;
+        if (cpu_string_equals(search_key_addr, cpu_dict_pair_key(dict->entries[pos]))) {
+            if (slot != NULL)
+                *slot = i;
+            return pos;
+        }
+    }
+}
+
+void cpu_dict_build_index(cpu_dict* dict)
+{
+    free(dict->index);
+
+    // Keep the load factor, tombstones included, below 1/2
+    u64 capacity = 8;
+    while (capacity < 2 * (dict->used + 1))
+        capacity *= 2;
+
+    dict->index = malloc((capacity + 1) * sizeof(i64));
+    dict->index[0] = capacity;
+    i64* slots = &dict->index[1];
+    for (u64 i = 0; i < capacity; i++)
+        slots[i] = CPU_DICT_SLOT_EMPTY;
+
+    for (size_t pos = 0; pos < dict->used; pos++) {
+        i64 key_value_pair = dict->entries[pos];
+        if (key_value_pair == 0)
+            continue;
+        cpu_dict_index_insert(dict, pos);
     }
 }
 
+void cpu_dict_index_insert(cpu_dict* dict, size_t pos)
+{
+    u64 mask = (u64)dict->index[0] - 1;
+    i64* slots = &dict->index[1];
+    u64 i = intern_hash(cpu_dict_pair_key(dict->entries[pos])) & mask;
+    while (slots[i] != CPU_DICT_SLOT_EMPTY)
+        i = (i + 1) & mask;
+    slots[i] = pos;
+}
+
+void cpu_dict_insert(cpu_dict* dict, i64 key_value_pair)
+{
+    if (dict->used == dict->capacity) {
+        // Drop the tombstones first, grow only if it's still full
+        if (dict->size != dict->used)
+            cpu_dict_compact(dict);
+    }
+
+    if (dict->used == dict->capacity) {
+        size_t capacity = dict->capacity < 4 ? 4 : dict->capacity * 2;
+        i64* entries = malloc(capacity * sizeof(i64));
+        memcpy(entries, dict->entries, dict->used * sizeof(i64));
+        // Entries that follow the header are owned by the header's allocation
+        if (dict->entries != (i64*)((i64)dict + sizeof(cpu_dict)))
+            free(dict->entries);
+        dict->entries = entries;
+        dict->capacity = capacity;
+    }
+
+    dict->entries[dict->used++] = key_value_pair;
+    dict->size += 1;
+
+    if (dict->index != NULL) {
+        if (2 * dict->used > (size_t)dict->index[0])
+            cpu_dict_build_index(dict);
+        else
+            cpu_dict_index_insert(dict, dict->used - 1);
+    }
+}
+
+void cpu_dict_compact(cpu_dict* dict)
+{
+    size_t j = 0;
+    for (size_t i = 0; i < dict->used; i++) {
+        if (dict->entries[i] != 0)
+            dict->entries[j++] = dict->entries[i];
+    }
+    dict->used = j;
+
+    if (dict->index != NULL)
+        cpu_dict_build_index(dict);
+}
+
+i64 cpu_dict_entry_access(i64 addr, i64 i, i64 pair)
+{
+    cpu_dict* dict = (cpu_dict*)addr;
+    if (dict->used != dict->size)
+        cpu_dict_compact(dict);
+    if (dict->value_type == V_ANY)
+        return dict->entries[i];
+
+    // Unboxed values are returned through the caller's pair, its value cell follows the pair
+    i64* p = (i64*)pair;
+    p[0] = *(i64*)dict->entries[i];
+    p[1] = cpu_dict_value(dict, dict->entries[i], &p[2]);
+    return pair;
+}
+
+i64 cpu_dict_value(cpu_dict* dict, i64 key_value_pair, i64* cell)
+{
+    i64 value = *(i64*)(key_value_pair + sizeof(i64));
+    if (dict->value_type == V_ANY)
+        return value;
+
+    // Unboxed values are copied into the caller's cell along with the dictionary's value type
+    cell[0] = dict->value_type;
+    cell[1] = value;
+    return (i64)cell;
+}
+
+void cpu_dict_box(cpu_dict* dict)
+{
+    for (size_t i = 0; i < dict->used; i++) {
+        i64 key_value_pair = dict->entries[i];
+        if (key_value_pair == 0)
+            continue;
+
+        i64* value = (i64*)(key_value_pair + sizeof(i64));
+        *value = cpu_new_common(dict->value_type, *value);
+    }
+    dict->value_type = V_ANY;
+}
+
 i64 cpu_string_concat(i64 addr1, i64 addr2)
 {
-    size_t* t1 = (size_t*)addr1;
-    size_t* t2 = (size_t*)addr2;
-    size_t t3 = *t1 + *t2;
-    addr1 += sizeof(size_t);
-    addr2 += sizeof(size_t);
-    char *s1 = (char*)addr1;
-    char *s2 = (char*)addr2;
+    char buf1[CPU_SSO_MAX + 1];
+    char buf2[CPU_SSO_MAX + 1];
+    size_t t1 = cpu_string_len(addr1);
+    size_t t2 = cpu_string_len(addr2);
+    size_t t3 = t1 + t2;
+    char *s1 = cpu_string_chars(addr1, buf1);
+    char *s2 = cpu_string_chars(addr2, buf2);
+
+    // The result fits into the value word
+    if (t3 <= CPU_SSO_MAX) {
+        char buf3[CPU_SSO_MAX + 1];
+        memcpy(buf3, s1, t1 * sizeof(char));
+        memcpy(buf3 + t1, s2, t2 * sizeof(char));
+        return cpu_string_pack(buf3, t3);
+    }
 
     // Allocate a new space to store the concatenated string
     i64 p = (i64)malloc((t3 + 1) * sizeof(char) + sizeof(size_t));
@@ -1179,47 +1747,272 @@ i64 cpu_string_concat(i64 addr1, i64 addr2)
     // Copy the first string
     p += sizeof(size_t);
     char *p_s = (char*)p;
-    strcpy(p_s, s1);
+    memcpy(p_s, s1, t1 * sizeof(char));
 
-    // Copy the second string
-    p += *t1 * sizeof(char);
+    // Copy the second string, views are not null-terminated
+    p += t1 * sizeof(char);
     char *p_s2 = (char*)p;
-    strcpy(p_s2, s2);
+    memcpy(p_s2, s2, t2 * sizeof(char));
+    p_s2[t2] = '\0';
 
     // Reset the pointer and return
-    p -= sizeof(size_t) + *t1 * sizeof(char);
+    p -= sizeof(size_t) + t1 * sizeof(char);
     return p;
 }
 
-i64 cpu_boolean_to_string(i64 val)
+i64 cpu_string_concat_n(i64 refs, i64 n)
 {
+    i64* parts = (i64*)refs;
+    size_t len = 0;
+    for (i64 i = 0; i < n; i++)
+        len += cpu_string_len(parts[i]);
+
+    // Size the result once, either the value word or a single allocation
+    char buf[CPU_SSO_MAX + 1];
     i64 p = 0;
-    size_t* p_t = 0;
-    if (val == 0) {
-        p = (i64)malloc((strlen("false") + 1) * sizeof(size_t));
-        p_t = (size_t*)p;
-        *p_t = 5;
-        p += sizeof(size_t);
-        char *p_s = (char*)p;
-        strcpy(p_s, "false");
-    } else {
-        p = (i64)malloc((strlen("true") + 1) * sizeof(size_t));
-        p_t = (size_t*)p;
-        *p_t = 4;
-        p += sizeof(size_t);
-        char *p_s = (char*)p;
-        strcpy(p_s, "true");
+    char *s = cpu_string_reserve(len, buf, &p);
+
+    char *dest = s;
+    for (i64 i = 0; i < n; i++) {
+        char part_buf[CPU_SSO_MAX + 1];
+        size_t part_len = cpu_string_len(parts[i]);
+        memcpy(dest, cpu_string_chars(parts[i], part_buf), part_len * sizeof(char));
+        dest += part_len;
     }
 
-    p -= sizeof(size_t);
+    return cpu_string_finish(s, len, p);
+}
+
+char* cpu_string_reserve(size_t len, char* buf, i64* p)
+{
+    // Short results are written into the caller's buffer and packed later
+    if (len <= CPU_SSO_MAX)
+        return buf;
+
+    *p = (i64)malloc((len + 1) * sizeof(char) + sizeof(size_t));
+    *(size_t*)*p = len;
+    return (char*)(*p + sizeof(size_t));
+}
+
+i64 cpu_string_finish(char* s, size_t len, i64 p)
+{
+    if (len <= CPU_SSO_MAX)
+        return cpu_string_pack(s, len);
+
+    s[len] = '\0';
     return p;
 }
 
+/*
+  join, split, replace and repeat receive their arguments as an array of
+  value words, in the order of the parameters. Every result is sized before
+  it is written, so a string is allocated once no matter how many parts it
+  is made of.
+*/
+i64 cpu_string_join(i64 args)
+{
+    i64* arg = (i64*)args;
+    cpu_list* list = (cpu_list*)arg[0];
+    char sep_buf[CPU_SSO_MAX + 1];
+    size_t sep_len = cpu_string_len(arg[1]);
+    char *sep = cpu_string_chars(arg[1], sep_buf);
+    i64 cell[2];
+
+    // Anything other than strings is formatted the way it is printed
+    if (list->value_type != V_STRING) {
+        for (size_t i = 0; i < list->size; i++) {
+            if (list->value_type != V_ANY || *(i64*)cpu_list_item(list, i, cell) != V_STRING)
+                return cpu_string_join_values(list, sep, sep_len);
+        }
+    }
+
+    size_t len = list->size == 0 ? 0 : (list->size - 1) * sep_len;
+    for (size_t i = 0; i < list->size; i++)
+        len += cpu_string_len(*(i64*)(cpu_list_item(list, i, cell) + sizeof(i64)));
+
+    char buf[CPU_SSO_MAX + 1];
+    i64 p = 0;
+    char *s = cpu_string_reserve(len, buf, &p);
+
+    char *dest = s;
+    for (size_t i = 0; i < list->size; i++) {
+        if (i != 0) {
+            memcpy(dest, sep, sep_len * sizeof(char));
+            dest += sep_len;
+        }
+        i64 ref = *(i64*)(cpu_list_item(list, i, cell) + sizeof(i64));
+        char part_buf[CPU_SSO_MAX + 1];
+        size_t part_len = cpu_string_len(ref);
+        memcpy(dest, cpu_string_chars(ref, part_buf), part_len * sizeof(char));
+        dest += part_len;
+    }
+
+    return cpu_string_finish(s, len, p);
+}
+
+i64 cpu_string_join_values(cpu_list* list, char* sep, size_t sep_len)
+{
+    cpu_output_buffer* previous = cpu_output_redirect(new_cpu_output_string());
+    i64 cell[2];
+    for (size_t i = 0; i < list->size; i++) {
+        if (i != 0)
+            cpu_output_write(sep, sep_len);
+        i64 value = cpu_list_item(list, i, cell);
+        if (*(i64*)value == V_STRING)
+            cpu_print_string(*(i64*)(value + sizeof(i64)), false);
+        else
+            cpu_print_flex(value);
+    }
+
+    cpu_output_buffer* buffer = cpu_output_redirect(previous);
+    size_t len = cpu_output_length(buffer);
+    char *s = cpu_output_release_string(buffer);
+    i64 ref = cpu_string_make(s, len);
+    free(s);
+    return ref;
+}
+
+i64 cpu_string_split(i64 args)
+{
+    i64* arg = (i64*)args;
+    i64 text = arg[0];
+    char text_buf[CPU_SSO_MAX + 1];
+    char sep_buf[CPU_SSO_MAX + 1];
+    size_t text_len = cpu_string_len(text);
+    size_t sep_len = cpu_string_len(arg[1]);
+    char *s = cpu_string_chars(text, text_buf);
+    char *sep = cpu_string_chars(arg[1], sep_buf);
+
+    // An empty separator splits the string into its characters
+    size_t count = text_len;
+    if (sep_len != 0) {
+        count = 1;
+        size_t offset = 0;
+        i64 pos;
+        while ((pos = cpu_bytes_find(s + offset, text_len - offset, sep, sep_len)) != CPU_BYTES_NOT_FOUND) {
+            offset += pos + sep_len;
+            count++;
+        }
+    }
+
+    // The parts are slices of the string, they share its characters
+    cpu_list* list = (cpu_list*)malloc(sizeof(cpu_list) + count * sizeof(i64));
+    list->size = count;
+    list->capacity = count;
+    list->head = 0;
+    list->items = (i64*)(list + 1);
+    list->value_type = V_STRING;
+
+    if (sep_len == 0) {
+        for (size_t i = 0; i < count; i++)
+            list->items[i] = cpu_string_slice(text, i, i + 1);
+        return (i64)list;
+    }
+
+    size_t offset = 0;
+    for (size_t i = 0; i < count - 1; i++) {
+        size_t pos = offset + cpu_bytes_find(s + offset, text_len - offset, sep, sep_len);
+        list->items[i] = cpu_string_slice(text, offset, pos);
+        offset = pos + sep_len;
+    }
+    list->items[count - 1] = cpu_string_slice(text, offset, text_len);
+
+    return (i64)list;
+}
+
+i64 cpu_string_replace(i64 args)
+{
+    i64* arg = (i64*)args;
+    i64 text = arg[0];
+    char text_buf[CPU_SSO_MAX + 1];
+    char old_buf[CPU_SSO_MAX + 1];
+    char new_buf[CPU_SSO_MAX + 1];
+    size_t text_len = cpu_string_len(text);
+    size_t old_len = cpu_string_len(arg[1]);
+    size_t new_len = cpu_string_len(arg[2]);
+    char *s = cpu_string_chars(text, text_buf);
+    char *old = cpu_string_chars(arg[1], old_buf);
+    char *new = cpu_string_chars(arg[2], new_buf);
+
+    if (old_len == 0)
+        return text;
+
+    size_t count = 0;
+    size_t offset = 0;
+    i64 pos;
+    while ((pos = cpu_bytes_find(s + offset, text_len - offset, old, old_len)) != CPU_BYTES_NOT_FOUND) {
+        offset += pos + old_len;
+        count++;
+    }
+
+    // Strings are immutable unless they are owned, the original can be shared
+    if (count == 0)
+        return text;
+
+    size_t len = text_len - count * old_len + count * new_len;
+    char buf[CPU_SSO_MAX + 1];
+    i64 p = 0;
+    char *dest = cpu_string_reserve(len, buf, &p);
+    char *start = dest;
+
+    offset = 0;
+    for (size_t i = 0; i < count; i++) {
+        pos = cpu_bytes_find(s + offset, text_len - offset, old, old_len);
+        memcpy(dest, s + offset, pos * sizeof(char));
+        dest += pos;
+        memcpy(dest, new, new_len * sizeof(char));
+        dest += new_len;
+        offset += pos + old_len;
+    }
+    memcpy(dest, s + offset, (text_len - offset) * sizeof(char));
+
+    return cpu_string_finish(start, len, p);
+}
+
+i64 cpu_string_repeat(i64 args)
+{
+    i64* arg = (i64*)args;
+    i64 text = arg[0];
+    i64 n = arg[1];
+    size_t text_len = cpu_string_len(text);
+    if (n <= 0 || text_len == 0)
+        return cpu_string_pack("", 0);
+
+    // The result and its length prefix have to fit into size_t
+    if ((unsigned long long)n > (SIZE_MAX - sizeof(size_t) - 1) / text_len)
+        throw_error(E_STRING_LENGTH_OVERFLOW, NULL, NULL, n, text_len);
+
+    char text_buf[CPU_SSO_MAX + 1];
+    char *s = cpu_string_chars(text, text_buf);
+    size_t len = text_len * (size_t)n;
+    char buf[CPU_SSO_MAX + 1];
+    i64 p = 0;
+    char *dest = cpu_string_reserve(len, buf, &p);
+
+    // Double the copied part until the result is filled
+    memcpy(dest, s, text_len * sizeof(char));
+    size_t copied = text_len;
+    while (copied < len) {
+        size_t chunk = copied < len - copied ? copied : len - copied;
+        memcpy(dest + copied, dest, chunk * sizeof(char));
+        copied += chunk;
+    }
+
+    return cpu_string_finish(dest, len, p);
+}
+
+i64 cpu_boolean_to_string(i64 val)
+{
+    // Both "true" and "false" fit into the value word
+    if (val == 0)
+        return cpu_string_pack("false", 5);
+    else
+        return cpu_string_pack("true", 4);
+}
+
 i64 cpu_string_to_boolean(i64 addr)
 {
-    addr += sizeof(size_t);
-    char *s = (char*)addr;
-    if (strlen(s) == 0)
+    if (cpu_string_len(addr) == 0)
         return 0;
     else
         return 1;
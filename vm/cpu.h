@@ -27,8 +27,15 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
 
 #include "ir.h"
+#include "intern.h"
+#include "bytes.h"
+#include "output.h"
+#include "format.h"
 
 #include "../enums.h"
 #include "../utilities/helpers.h"
@@ -39,6 +46,148 @@
 i64* ast_stack;
 i64 ast_stack_p;
 
+// The cell returned for a missing dictionary key
+i64 cpu_void_cell[2];
+
+/*
+  Strings that are at most CPU_SSO_MAX bytes long are stored inline in the
+  value word instead of being referenced through a pointer. The lowest bit
+  of the word tags the inline form, string pointers are always aligned.
+
+  0      1                              8
+  +------+ +---------------------------+
+  | tag  | |          string           |
+  +------+ +---------------------------+
+   (size << 1) | 1     size * char
+*/
+#define CPU_SSO_MAX 7
+#define CPU_STRING_IS_INLINE(ref) (((ref) & 1) == 1)
+
+/*
+  `s = s + y` appends to a string builder in place. A builder has spare
+  capacity and remembers the variable cell that owns it. Loading the
+  string from a variable gives the ownership up, so a builder that may be
+  referenced from anywhere else is copied instead of being appended to.
+  The reference points to the size field, tagged with
+  CPU_STRING_BUILDER_TAG, so it reads like any other long string.
+
+  0       8          16     24                   size+24
+  +-------+----------+------+ +-----------------+ +-----------------+
+  | owner | capacity | size | |     string      | | null-terminator |
+  +-------+----------+------+ +-----------------+ +-----------------+
+    i64     size_t    size_t      size * char             char
+*/
+#define CPU_STRING_BUILDER_MIN_CAPACITY 32
+#define CPU_STRING_IS_BUILDER(ref) (((ref) & 7) == CPU_STRING_BUILDER_TAG)
+
+/*
+  Slicing a string longer than CPU_SSO_MAX does not copy the characters,
+  it returns a view into the sliced string instead. The reference points
+  to the size field, tagged with CPU_STRING_VIEW_TAG. The characters of a
+  view are not null-terminated.
+
+  0      8
+  +------+-------+
+  | size | chars |
+  +------+-------+
+   size_t  char*
+
+  Strings are never written to unless the variable cell owns a builder
+  with them, everything else is copied into a new builder first. So the
+  characters a view points to never change and a view can be shared like
+  an interned string. A view of a view points to the original characters.
+*/
+#define CPU_STRING_IS_VIEW(ref) (((ref) & 7) == CPU_STRING_VIEW_TAG)
+#define CPU_STRING_SLICE_END LLONG_MAX
+
+/*
+  Dictionaries keep their key-value pairs in a dense, insertion-ordered
+  array. Deleted pairs leave a tombstone (0) behind until the array is
+  compacted. Once a dictionary grows beyond CPU_DICT_INDEX_THRESHOLD
+  entries an open-addressing hash index is built lazily, it maps the hash
+  of a key to the position of its pair in the entries array.
+
+  0      8      16         24        32      40           48
+  +------+------+----------+---------+-------+------------+ +---------------------+
+  | size | used | capacity | entries | index | value_type | | key-value pair refs |
+  +------+------+----------+---------+-------+------------+ +---------------------+
+   size_t size_t  size_t      i64*     i64*       i64              used * i64
+
+  The entries point right after the header until the dictionary grows.
+  The index is | capacity | slots |, a slot holds the position of a pair.
+
+  If value_type is not V_ANY the second word of a pair holds the value
+  itself (an int, the bits of a float or a string ref) instead of a ref to
+  a boxed cell. A value of any other type boxes the whole dictionary.
+*/
+#define CPU_DICT_INDEX_THRESHOLD 8
+#define CPU_DICT_SLOT_EMPTY -1
+#define CPU_DICT_SLOT_DELETED -2
+
+/*
+  Lists keep their element refs in a ring buffer so that removing an element
+  from either end does not move the rest. Element i lives in the slot
+  (head + i) % capacity. Appending doubles the capacity once the buffer is
+  full, which makes it amortised O(1).
+
+  0      8          16     24      32           40
+  +------+----------+------+-------+------------+ +-----------------------+
+  | size | capacity | head | items | value_type | |   element refs        |
+  +------+----------+------+-------+------------+ +-----------------------+
+   size_t  size_t    size_t  i64*       i64            capacity * i64
+
+  The items point right after the header until the list grows.
+
+  Like dictionaries, a list with a value_type other than V_ANY stores its
+  elements unboxed, an item is the value itself instead of a cell ref.
+*/
+#define CPU_LIST_MIN_CAPACITY 4
+
+typedef struct cpu_string_builder {
+    i64 owner;
+    size_t capacity;
+    size_t size;
+    char chars[];
+} cpu_string_builder;
+
+typedef struct cpu_string_view {
+    size_t size;
+    char* chars;
+} cpu_string_view;
+
+typedef struct cpu_dict {
+    size_t size;
+    size_t used;
+    size_t capacity;
+    i64* entries;
+    i64* index;
+    i64 value_type;
+} cpu_dict;
+
+typedef struct cpu_list {
+    size_t size;
+    size_t capacity;
+    size_t head;
+    i64* items;
+    i64 value_type;
+} cpu_list;
+
+/*
+  Lists and dictionaries are printed without recursion, every container
+  that is being printed has a frame on an explicit stack. i is the position
+  of the next element (or key-value pair) and printed is the number of
+  elements printed so far.
+*/
+typedef struct cpu_print_frame {
+    i64 addr;
+    i64 type;
+    size_t i;
+    size_t printed;
+} cpu_print_frame;
+
+cpu_print_frame* cpu_print_stack;
+size_t cpu_print_stack_capacity;
+
 typedef struct jit_label_array {
     jit_label** arr;
     i64 capacity;
@@ -74,24 +223,65 @@ void cpu_print_bool(i64 i);
 void cpu_print_int(i64 i);
 void cpu_print_float(f64 f);
 void cpu_print_string(i64 addr, bool quoted);
-void cpu_print_flex(i64 addr, i64 pretty, unsigned long iter);
-void cpu_print_list(i64 addr, i64 pretty, unsigned long iter);
-void cpu_print_dict(i64 addr, i64 pretty, unsigned long iter);
+void cpu_print_flex(i64 addr);
+void cpu_print_composite(i64 addr, i64 type, i64 pretty);
+void cpu_print_open(i64 type, i64 pretty);
 
-void cpu_delete_string_index(i64 index, i64 addr);
+size_t cpu_string_len(i64 ref);
+char* cpu_string_chars(i64 ref, char* buf);
+i64 cpu_string_pack(char* s, size_t len);
+i64 cpu_string_make(char* s, size_t len);
+bool cpu_string_equals(i64 ref1, i64 ref2);
+i64 cpu_string_differs(i64 ref1, i64 ref2);
+i64 cpu_string_compare(i64 ref1, i64 ref2);
+i64 cpu_string_index(i64 i, size_t len);
+i64 cpu_string_index_access(i64 ref, i64 i);
+void cpu_string_index_update(i64 cell, i64 i, i64 char_ref);
+void cpu_string_append(i64 cell, i64 ref);
+cpu_string_builder* cpu_string_own(i64 cell, size_t extra);
+i64 cpu_string_slice(i64 ref, i64 low, i64 high);
+void cpu_string_share(i64 ref);
+
+void cpu_delete_string_index(i64 index, i64 cell);
 void cpu_delete_list_index(i64 index, i64 addr);
 void cpu_delete_dict_key(i64 search_key_addr, i64 addr);
 i64 cpu_string_concat(i64 addr1, i64 addr2);
+i64 cpu_string_concat_n(i64 refs, i64 n);
+char* cpu_string_reserve(size_t len, char* buf, i64* p);
+i64 cpu_string_finish(char* s, size_t len, i64 p);
+i64 cpu_string_join(i64 args);
+i64 cpu_string_join_values(cpu_list* list, char* sep, size_t sep_len);
+i64 cpu_string_split(i64 args);
+i64 cpu_string_replace(i64 args);
+i64 cpu_string_repeat(i64 args);
 i64 cpu_boolean_to_string(i64 val);
 i64 cpu_string_to_boolean(i64 addr);
-i64 cpu_composite_access(i64 addr, i64 type, i64 val);
-i64 cpu_list_index_access(i64 addr, i64 i);
-i64 cpu_dict_key_search(i64 addr, i64 search_key_addr);
+i64 cpu_composite_access(i64 addr, i64 type, i64 val, i64 cell);
+i64 cpu_list_index_access(i64 addr, i64 i, i64* cell);
+i64 cpu_dict_key_search(i64 addr, i64 search_key_addr, i64* cell);
 void cpu_list_index_update(i64 addr, i64 i, i64 r0, i64 r1, f64 fr1);
+i64* cpu_list_slot(cpu_list* list, size_t i);
+i64 cpu_list_item(cpu_list* list, size_t i, i64* cell);
+void cpu_list_box(cpu_list* list);
+void cpu_list_grow(cpu_list* list);
+void cpu_list_append(i64 addr, i64 r0, i64 r1, f64 fr1);
 void cpu_dict_key_update(i64 addr, i64 search_key_addr, i64 r0, i64 r1, f64 fr1);
+i64 cpu_dict_pair_key(i64 key_value_pair);
+i64 cpu_dict_lookup(cpu_dict* dict, i64 search_key_addr, i64* slot);
+void cpu_dict_build_index(cpu_dict* dict);
+void cpu_dict_index_insert(cpu_dict* dict, size_t pos);
+void cpu_dict_insert(cpu_dict* dict, i64 key_value_pair);
+void cpu_dict_compact(cpu_dict* dict);
+i64 cpu_dict_entry_access(i64 addr, i64 i, i64 pair);
+i64 cpu_dict_value(cpu_dict* dict, i64 key_value_pair, i64* cell);
+void cpu_dict_box(cpu_dict* dict);
 
 i64 cpu_new_common(i64 type, i64 val);
+i64 cpu_new_value(i64 type, i64 val);
+i64 cpu_new_item(i64 value_type, i64 r0, i64 r1, f64 fr1);
+i64 cpu_value_word(i64 r0, i64 r1, f64 fr1);
 i64 cpu_new_string(i64 addr);
+i64 cpu_string_copy(i64 ref);
 void cpu_new_list(i64 addr, i64 new_addr);
 void cpu_new_dict(i64 addr, i64 new_addr);
 
@@ -150,12 +340,30 @@ void debug(struct jit *jit);
     /* Set the jump point to dodge the float operation */ \
     jit_patch(_jit, float_op_label_2); \
 
-#define DYN_BINARY_COMPARISON(_fn, _ffn) \
+#define DYN_BINARY_COMPARISON(_fn, _ffn, _sfn) \
+    /* Check if both of the operands are strings */ \
+    jit_op* string_op_label_1 = jit_bnei(_jit, JIT_FORWARD, R(0), V_STRING); \
+    jit_op* string_op_label_2 = jit_bnei(_jit, JIT_FORWARD, R(4), V_STRING); \
+\
+    /* Compare the strings, then compare the result with zero like integers */ \
+    jit_movi(_jit, R(2), _sfn); \
+    jit_prepare(_jit); \
+    jit_putargr(_jit, R(1)); \
+    jit_putargr(_jit, R(5)); \
+    jit_callr(_jit, R(2)); \
+    jit_retval(_jit, R(1)); \
+    jit_movi(_jit, R(5), 0); \
+    jit_op* string_op_label_3 = jit_jmpi(_jit, JIT_FORWARD); \
+\
+    jit_patch(_jit, string_op_label_1); \
+    jit_patch(_jit, string_op_label_2); \
+\
     /* Check if any of the operands are float */ \
     jit_op* float_op_label_1 = jit_beqi(_jit, JIT_FORWARD, R(0), V_FLOAT); \
     jit_op* float_op_label_2 = jit_beqi(_jit, JIT_FORWARD, R(4), V_FLOAT); \
 \
     /* It's an integer operation, do the operation */ \
+    jit_patch(_jit, string_op_label_3); \
     jit_movi(_jit, R(3), 1); \
     jit_op* float_comp_label_true_int = _fn(_jit, JIT_FORWARD, R(1), R(5)); \
     jit_movi(_jit, R(3), 0); \
@@ -0,0 +1,341 @@
+/*
+ * Description: Number formatting module of the Chaos Programming Language's source
+ *
+ * Copyright (c) 2019-2021 Chaos Language Development Authority <info@chaos-lang.org>
+ *
+ * License: GNU General Public License v3.0
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors: M. Mert Yildiran <me@mertyildiran.com>
+ */
+
+#include "format.h"
+
+char cpu_digit_pairs[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+u64 cpu_pow10[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+    100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+    10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+};
+
+// Normalized 64-bit significands and binary exponents of 10^-348, 10^-340, ..., 10^340
+u64 cpu_cached_powers_f[] = {
+0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL,
+    0xcf42894a5dce35eaULL, 0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL,
+    0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL, 0xbe5691ef416bd60cULL,
+    0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+    0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL,
+    0xc21094364dfb5637ULL, 0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL,
+    0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL, 0xb23867fb2a35b28eULL,
+    0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+    0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL,
+    0xb5b5ada8aaff80b8ULL, 0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL,
+    0x964e858c91ba2655ULL, 0xdff9772470297ebdULL, 0xa6dfbd9fb8e5b88fULL,
+    0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+    0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL,
+    0xaa242499697392d3ULL, 0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL,
+    0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL, 0x9c40000000000000ULL,
+    0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+    0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL,
+    0x9f4f2726179a2245ULL, 0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL,
+    0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL, 0x924d692ca61be758ULL,
+    0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+    0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL,
+    0x952ab45cfa97a0b3ULL, 0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL,
+    0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL, 0x88fcf317f22241e2ULL,
+    0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+    0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL,
+    0x8bab8eefb6409c1aULL, 0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL,
+    0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL, 0x80444b5e7aa7cf85ULL,
+    0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+    0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL
+};
+
+int cpu_cached_powers_e[] = {
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980,
+    -954, -927, -901, -874, -847, -821, -794, -768, -741, -715,
+    -688, -661, -635, -608, -582, -555, -529, -502, -475, -449,
+    -422, -396, -369, -343, -316, -289, -263, -236, -210, -183,
+    -157, -130, -103, -77, -50, -24, 3, 30, 56, 83,
+    109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614,
+    641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+    907, 933, 960, 986, 1013, 1039, 1066
+};
+
+size_t cpu_format_uint(u64 n, char* buf)
+{
+    char tmp[20];
+    char* p = tmp + sizeof(tmp);
+    while (n >= 100) {
+        u64 q = n / 100;
+        p -= 2;
+        memcpy(p, &cpu_digit_pairs[(n - q * 100) * 2], 2);
+        n = q;
+    }
+    if (n >= 10) {
+        p -= 2;
+        memcpy(p, &cpu_digit_pairs[n * 2], 2);
+    } else {
+        *--p = (char)('0' + n);
+    }
+
+    size_t len = tmp + sizeof(tmp) - p;
+    memcpy(buf, p, len);
+    return len;
+}
+
+size_t cpu_format_int(i64 i, char* buf)
+{
+    if (i >= 0)
+        return cpu_format_uint((u64)i, buf);
+
+    // Negate in unsigned arithmetic, -LLONG_MIN does not fit into an i64
+    buf[0] = '-';
+    return 1 + cpu_format_uint(0 - (u64)i, buf + 1);
+}
+
+size_t cpu_format_exponent(int e, char* buf)
+{
+    // Like `%g`, a sign and at least two digits
+    size_t len = 0;
+    buf[len++] = 'e';
+    if (e < 0) {
+        buf[len++] = '-';
+        e = -e;
+    } else {
+        buf[len++] = '+';
+    }
+    if (e < 10)
+        buf[len++] = '0';
+    return len + cpu_format_uint((u64)e, buf + len);
+}
+
+size_t cpu_format_float(f64 f, char* buf)
+{
+    u64 bits;
+    memcpy(&bits, &f, sizeof(f64));
+
+    size_t len = 0;
+    if (bits >> 63) {
+        buf[len++] = '-';
+        bits &= ~(1ULL << 63);
+        memcpy(&f, &bits, sizeof(f64));
+    }
+
+    if ((bits >> 52) == 0x7ff) {
+        memcpy(buf + len, (bits & ((1ULL << 52) - 1)) ? "nan" : "inf", 3);
+        return len + 3;
+    }
+
+    if (bits == 0) {
+        buf[len++] = '0';
+        return len;
+    }
+
+    char digits[18];
+    int digit_count;
+    int k;
+    cpu_grisu2(f, digits, &digit_count, &k);
+
+    // The value is 0.digits * 10^point
+    int point = digit_count + k;
+    int exponent = point - 1;
+
+    if (exponent < CPU_FORMAT_EXP_MIN || exponent >= CPU_FORMAT_EXP_MAX) {
+        buf[len++] = digits[0];
+        if (digit_count > 1) {
+            buf[len++] = '.';
+            memcpy(buf + len, digits + 1, digit_count - 1);
+            len += digit_count - 1;
+        }
+        return len + cpu_format_exponent(exponent, buf + len);
+    }
+
+    if (point >= digit_count) {
+        // An integral value, no trailing decimal point
+        memcpy(buf + len, digits, digit_count);
+        len += digit_count;
+        memset(buf + len, '0', point - digit_count);
+        return len + point - digit_count;
+    }
+
+    if (point > 0) {
+        memcpy(buf + len, digits, point);
+        len += point;
+        buf[len++] = '.';
+        memcpy(buf + len, digits + point, digit_count - point);
+        return len + digit_count - point;
+    }
+
+    buf[len++] = '0';
+    buf[len++] = '.';
+    memset(buf + len, '0', -point);
+    len += -point;
+    memcpy(buf + len, digits, digit_count);
+    return len + digit_count;
+}
+
+cpu_diy_fp cpu_diy_fp_multiply(cpu_diy_fp x, cpu_diy_fp y)
+{
+    // The upper 64 bits of the 128-bit product, rounded
+    u64 m32 = 0xffffffffULL;
+    u64 a = x.f >> 32;
+    u64 b = x.f & m32;
+    u64 c = y.f >> 32;
+    u64 d = y.f & m32;
+    u64 ac = a * c;
+    u64 bc = b * c;
+    u64 ad = a * d;
+    u64 bd = b * d;
+    u64 tmp = (bd >> 32) + (ad & m32) + (bc & m32) + (1ULL << 31);
+
+    cpu_diy_fp result;
+    result.f = ac + (ad >> 32) + (bc >> 32) + (tmp >> 32);
+    result.e = x.e + y.e + 64;
+    return result;
+}
+
+cpu_diy_fp cpu_diy_fp_cached_power(int e, int* k)
+{
+    // Pick the power that scales the binary exponent into [-60, -32]
+    double dk = (-61 - e) * 0.30102999566398114 + 347;
+    int ik = (int)dk;
+    if (ik != dk)
+        ik++;
+
+    unsigned index = (unsigned)((ik >> 3) + 1);
+    *k = -(-348 + (int)(index << 3));
+
+    cpu_diy_fp power;
+    power.f = cpu_cached_powers_f[index];
+    power.e = cpu_cached_powers_e[index];
+    return power;
+}
+
+void cpu_grisu_round(char* buf, int len, u64 delta, u64 rest, u64 ten_kappa, u64 wp_w)
+{
+    // Move the last digit towards the exact value while staying in the rounding interval
+    while (
+        rest < wp_w && delta - rest >= ten_kappa &&
+        (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w)
+    ) {
+        buf[len - 1]--;
+        rest += ten_kappa;
+    }
+}
+
+void cpu_grisu_digit_gen(cpu_diy_fp w, cpu_diy_fp mp, u64 delta, char* buf, int* len, int* k)
+{
+    int shift = -mp.e;
+    u64 one = 1ULL << shift;
+    u64 wp_w = mp.f - w.f;
+    unsigned p1 = (unsigned)(mp.f >> shift);
+    u64 p2 = mp.f & (one - 1);
+
+    int kappa = 1;
+    while (kappa < 10 && p1 >= cpu_pow10[kappa])
+        kappa++;
+
+    *len = 0;
+    while (kappa > 0) {
+        unsigned d = (unsigned)(p1 / cpu_pow10[kappa - 1]);
+        p1 %= cpu_pow10[kappa - 1];
+        if (d || *len)
+            buf[(*len)++] = (char)('0' + d);
+        kappa--;
+        u64 rest = ((u64)p1 << shift) + p2;
+        if (rest <= delta) {
+            *k += kappa;
+            cpu_grisu_round(buf, *len, delta, rest, cpu_pow10[kappa] << shift, wp_w);
+            return;
+        }
+    }
+
+    for (;;) {
+        p2 *= 10;
+        delta *= 10;
+        char d = (char)(p2 >> shift);
+        if (d || *len)
+            buf[(*len)++] = (char)('0' + d);
+        p2 &= one - 1;
+        kappa--;
+        if (p2 < delta) {
+            *k += kappa;
+            cpu_grisu_round(buf, *len, delta, p2, one, -kappa < 20 ? wp_w * cpu_pow10[-kappa] : 0);
+            return;
+        }
+    }
+}
+
+void cpu_grisu2(f64 f, char* buf, int* len, int* k)
+{
+    u64 bits;
+    memcpy(&bits, &f, sizeof(f64));
+
+    cpu_diy_fp v;
+    int biased_e = (int)((bits >> 52) & 0x7ff);
+    v.f = bits & ((1ULL << 52) - 1);
+    if (biased_e != 0) {
+        v.f += 1ULL << 52;
+        v.e = biased_e - 1075;
+    } else {
+        v.e = -1074;
+    }
+
+    // The boundaries halfway to the neighbouring doubles, normalized to the same exponent
+    cpu_diy_fp plus;
+    plus.f = (v.f << 1) + 1;
+    plus.e = v.e - 1;
+    while (!(plus.f & (1ULL << 53))) {
+        plus.f <<= 1;
+        plus.e--;
+    }
+    plus.f <<= 10;
+    plus.e -= 10;
+
+    cpu_diy_fp minus;
+    if (v.f == 1ULL << 52) {
+        minus.f = (v.f << 2) - 1;
+        minus.e = v.e - 2;
+    } else {
+        minus.f = (v.f << 1) - 1;
+        minus.e = v.e - 1;
+    }
+    minus.f <<= minus.e - plus.e;
+    minus.e = plus.e;
+
+    cpu_diy_fp w = v;
+    while (!(w.f & (1ULL << 52))) {
+        w.f <<= 1;
+        w.e--;
+    }
+    w.f <<= 11;
+    w.e -= 11;
+
+    cpu_diy_fp c_mk = cpu_diy_fp_cached_power(plus.e, k);
+    w = cpu_diy_fp_multiply(w, c_mk);
+    plus = cpu_diy_fp_multiply(plus, c_mk);
+    minus = cpu_diy_fp_multiply(minus, c_mk);
+    minus.f++;
+    plus.f--;
+    cpu_grisu_digit_gen(w, plus, plus.f - minus.f, buf, len, k);
+}
@@ -0,0 +1,65 @@
+/*
+ * Description: Number formatting module of the Chaos Programming Language's source
+ *
+ * Copyright (c) 2019-2021 Chaos Language Development Authority <info@chaos-lang.org>
+ *
+ * License: GNU General Public License v3.0
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors: M. Mert Yildiran <me@mertyildiran.com>
+ */
+
+#ifndef FORMAT_H
+#define FORMAT_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "types.h"
+
+/*
+  Numbers are formatted without going through printf. Integers are written
+  two digits at a time from a table of digit pairs. Floats are printed with
+  digits that always read back as the same double and are the shortest such
+  digits for all but a tiny fraction of values (Grisu2). The notation is
+  fixed if the decimal exponent is in [CPU_FORMAT_EXP_MIN, CPU_FORMAT_EXP_MAX)
+  and scientific (like `%g`) otherwise.
+
+  The formatters write into the caller's buffer, which has to have room
+  for CPU_FORMAT_MAX characters, and return the number of characters
+  written. The result is not null-terminated.
+*/
+#define CPU_FORMAT_MAX 32
+#define CPU_FORMAT_EXP_MIN -4
+#define CPU_FORMAT_EXP_MAX 17
+
+// A floating-point number with a 64-bit significand, f * 2^e
+typedef struct cpu_diy_fp {
+    u64 f;
+    int e;
+} cpu_diy_fp;
+
+size_t cpu_format_uint(u64 n, char* buf);
+size_t cpu_format_int(i64 i, char* buf);
+size_t cpu_format_float(f64 f, char* buf);
+size_t cpu_format_exponent(int e, char* buf);
+
+cpu_diy_fp cpu_diy_fp_multiply(cpu_diy_fp x, cpu_diy_fp y);
+cpu_diy_fp cpu_diy_fp_cached_power(int e, int* k);
+void cpu_grisu_round(char* buf, int len, u64 delta, u64 rest, u64 ten_kappa, u64 wp_w);
+void cpu_grisu_digit_gen(cpu_diy_fp w, cpu_diy_fp mp, u64 delta, char* buf, int* len, int* k);
+void cpu_grisu2(f64 f, char* buf, int* len, int* k);
+
+#endif
@@ -0,0 +1,214 @@
+/*
+ * Description: String interning module of the Chaos Programming Language's source
+ *
+ * Copyright (c) 2019-2021 Chaos Language Development Authority <info@chaos-lang.org>
+ *
+ * License: GNU General Public License v3.0
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors: M. Mert Yildiran <me@mertyildiran.com>
+ */
+
+#include "intern.h"
+#include "cpu.h"
+
+intern_table* string_intern_table = NULL;
+intern_table* string_name_table = NULL;
+
+#if !defined(_WIN32) && !defined(_WIN64) && !defined(__CYGWIN__)
+static pthread_mutex_t name_table_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+u64 intern_hash_bytes(char* s, size_t len)
+{
+    // 64-bit FNV-1a
+    u64 hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (byte)s[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+u64 intern_entry_hash(i64 entry)
+{
+    // The names are 8-byte aligned, so clearing the string tags leaves them as they are
+    return *(u64*)(CPU_STRING_PTR(entry) - sizeof(u64));
+}
+
+i64* intern_table_find(intern_table** table, u64 hash, char* s, size_t len, intern_entry_equals equals)
+{
+    if (*table == NULL) {
+        *table = malloc(sizeof **table);
+        (*table)->capacity = 0;
+        (*table)->size = 0;
+        (*table)->arr = NULL;
+    }
+
+    // Keep the load factor below 1/2
+    if (((*table)->size + 1) * 2 > (*table)->capacity)
+        intern_table_grow(*table);
+
+    return intern_table_slot(*table, hash, s, len, equals);
+}
+
+i64* intern_table_slot(intern_table* table, u64 hash, char* s, size_t len, intern_entry_equals equals)
+{
+    u64 mask = table->capacity - 1;
+    u64 i = hash & mask;
+    for (;;) {
+        i64* slot = &table->arr[i];
+        if (*slot == 0)
+            return slot;
+
+        if (intern_entry_hash(*slot) == hash && equals(*slot, s, len))
+            return slot;
+
+        i = (i + 1) & mask;
+    }
+}
+
+void intern_table_grow(intern_table* table)
+{
+    u64 old_capacity = table->capacity;
+    i64* old_arr = table->arr;
+
+    table->capacity = old_capacity == 0 ? 64 : old_capacity * 2;
+    table->arr = calloc(table->capacity, sizeof(i64));
+
+    u64 mask = table->capacity - 1;
+    for (u64 i = 0; i < old_capacity; i++) {
+        i64 entry = old_arr[i];
+        if (entry == 0)
+            continue;
+        u64 j = intern_entry_hash(entry) & mask;
+        while (table->arr[j] != 0)
+            j = (j + 1) & mask;
+        table->arr[j] = entry;
+    }
+
+    free(old_arr);
+}
+
+void intern_table_free(intern_table** table)
+{
+    if (*table == NULL)
+        return;
+
+    for (u64 i = 0; i < (*table)->capacity; i++) {
+        i64 entry = (*table)->arr[i];
+        if (entry != 0)
+            free((void*)(CPU_STRING_PTR(entry) - sizeof(u64)));
+    }
+    free((*table)->arr);
+    free(*table);
+    *table = NULL;
+}
+
+u64 intern_hash(i64 ref)
+{
+    if (CPU_STRING_IS_INTERNED(ref))
+        return intern_entry_hash(ref);
+
+    char buf[CPU_SSO_MAX + 1];
+    return intern_hash_bytes(cpu_string_chars(ref, buf), cpu_string_len(ref));
+}
+
+static bool intern_string_equals(i64 entry, char* s, size_t len)
+{
+    i64 p = CPU_STRING_PTR(entry);
+    return cpu_bytes_equal((char*)(p + sizeof(size_t)), *(size_t*)p, s, len);
+}
+
+i64 intern_string(char* s, size_t len)
+{
+    // Inline strings are compared by value already
+    if (len <= CPU_SSO_MAX)
+        return cpu_string_pack(s, len);
+
+    u64 hash = intern_hash_bytes(s, len);
+    i64* slot = intern_table_find(&string_intern_table, hash, s, len, intern_string_equals);
+    if (*slot != 0)
+        return *slot;
+
+    i64 p = (i64)malloc(sizeof(u64) + sizeof(size_t) + (len + 1) * sizeof(char));
+    *(u64*)p = hash;
+    p += sizeof(u64);
+    *(size_t*)p = len;
+    char* p_s = (char*)(p + sizeof(size_t));
+    memcpy(p_s, s, len * sizeof(char));
+    p_s[len] = '\0';
+
+    *slot = p | CPU_STRING_INTERN_TAG;
+    string_intern_table->size++;
+    return *slot;
+}
+
+i64 intern_string_ref(i64 ref)
+{
+    if (CPU_STRING_IS_INLINE(ref) || CPU_STRING_IS_INTERNED(ref))
+        return ref;
+
+    char buf[CPU_SSO_MAX + 1];
+    return intern_string(cpu_string_chars(ref, buf), cpu_string_len(ref));
+}
+
+void free_intern_table()
+{
+    intern_table_free(&string_intern_table);
+}
+
+static bool intern_name_equals(i64 entry, char* s, size_t len)
+{
+    char* name = (char*)entry;
+    return strncmp(name, s, len) == 0 && name[len] == '\0';
+}
+
+char* intern_name(char* s, size_t len)
+{
+    u64 hash = intern_hash_bytes(s, len);
+
+#if !defined(_WIN32) && !defined(_WIN64) && !defined(__CYGWIN__)
+    pthread_mutex_lock(&name_table_mutex);
+#endif
+
+    i64* slot = intern_table_find(&string_name_table, hash, s, len, intern_name_equals);
+    if (*slot == 0) {
+        char* p = malloc(sizeof(u64) + (len + 1) * sizeof(char));
+        *(u64*)p = hash;
+        char* name = p + sizeof(u64);
+        memcpy(name, s, len * sizeof(char));
+        name[len] = '\0';
+
+        *slot = (i64)name;
+        string_name_table->size++;
+    }
+    char* name = (char*)*slot;
+
+#if !defined(_WIN32) && !defined(_WIN64) && !defined(__CYGWIN__)
+    pthread_mutex_unlock(&name_table_mutex);
+#endif
+
+    return name;
+}
+
+u64 intern_name_hash(char* name)
+{
+    return intern_entry_hash((i64)name);
+}
+
+void free_name_table()
+{
+    intern_table_free(&string_name_table);
+}
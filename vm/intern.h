@@ -0,0 +1,104 @@
+/*
+ * Description: String interning module of the Chaos Programming Language's source
+ *
+ * Copyright (c) 2019-2021 Chaos Language Development Authority <info@chaos-lang.org>
+ *
+ * License: GNU General Public License v3.0
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors: M. Mert Yildiran <me@mertyildiran.com>
+ */
+
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#if !defined(_WIN32) && !defined(_WIN64) && !defined(__CYGWIN__)
+#   include <pthread.h>
+#endif
+
+#include "types.h"
+#include "bytes.h"
+
+/*
+  Interned strings are immutable and unique per content, so two interned
+  references are equal if and only if the strings are equal. The hash is
+  cached in front of the usual length-prefixed layout and the reference
+  points to the size field, tagged with CPU_STRING_INTERN_TAG.
+
+  0      8      16                   size+16            size+17
+  +------+------+ +-----------------+ +-----------------+
+  | hash | size | |     string      | | null-terminator |
+  +------+------+ +-----------------+ +-----------------+
+    u64   size_t      size * char             char
+*/
+#define CPU_STRING_INTERN_TAG 2
+#define CPU_STRING_IS_INTERNED(ref) (((ref) & 7) == CPU_STRING_INTERN_TAG)
+
+// String builders and views are tagged as well, see vm/cpu.h
+#define CPU_STRING_BUILDER_TAG 4
+#define CPU_STRING_VIEW_TAG 6
+#define CPU_STRING_PTR(ref) ((ref) & ~(i64)(CPU_STRING_INTERN_TAG | CPU_STRING_BUILDER_TAG))
+
+/*
+  Both tables below are open addressing tables with linear probing. An
+  entry is a pointer, tagged or not, that has the hash cached in the 8
+  bytes in front of it, so the probing and the growing are shared and only
+  the comparison of the contents differs.
+*/
+typedef struct intern_table {
+    i64* arr;
+    u64 capacity;
+    u64 size;
+} intern_table;
+
+typedef bool (*intern_entry_equals)(i64 entry, char* s, size_t len);
+
+intern_table* string_intern_table;
+
+u64 intern_hash_bytes(char* s, size_t len);
+u64 intern_entry_hash(i64 entry);
+i64* intern_table_find(intern_table** table, u64 hash, char* s, size_t len, intern_entry_equals equals);
+i64* intern_table_slot(intern_table* table, u64 hash, char* s, size_t len, intern_entry_equals equals);
+void intern_table_grow(intern_table* table);
+void intern_table_free(intern_table** table);
+
+u64 intern_hash(i64 ref);
+i64 intern_string(char* s, size_t len);
+i64 intern_string_ref(i64 ref);
+void free_intern_table();
+
+/*
+  Identifiers and string literals are interned by the lexer into a table of
+  plain C strings, so the AST, the symbols and the functions share one
+  canonical pointer per name. The name points to the string and its hash is
+  cached in front of it. The modules are parsed in parallel, so the table
+  is guarded by a mutex.
+
+  0      8                   len+8             len+9
+  +------+ +-----------------+ +-----------------+
+  | hash | |     string      | | null-terminator |
+  +------+ +-----------------+ +-----------------+
+    u64        len * char             char
+*/
+intern_table* string_name_table;
+
+char* intern_name(char* s, size_t len);
+u64 intern_name_hash(char* name);
+void free_name_table();
+
+#endif
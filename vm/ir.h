@@ -81,9 +81,14 @@ enum IROpCode {
     // Dynamic Index Delete
     DYN_STR_INDEX_DELETE, DYN_LIST_INDEX_DELETE, DYN_DICT_KEY_DELETE,
     // Dynamic Index Access
-    DYN_STR_INDEX_ACCESS, DYN_COMP_ACCESS,
+    DYN_STR_INDEX_ACCESS, DYN_COMP_ACCESS, DYN_DICT_ENTRY_ACCESS,
     // Dynamic Index Update
-    DYN_LIST_INDEX_UPDATE, DYN_DICT_KEY_UPDATE,
+    DYN_STR_INDEX_UPDATE, DYN_LIST_INDEX_UPDATE, DYN_DICT_KEY_UPDATE,
+    // Dynamic String Append
+    DYN_STR_APPEND, DYN_STR_SHARE, DYN_STR_CONCAT, DYN_STR_SLICE,
+    DYN_STR_JOIN, DYN_STR_SPLIT, DYN_STR_REPLACE, DYN_STR_REPEAT,
+    // Dynamic List Append
+    DYN_LIST_APPEND,
     // Dynamic Type Conversion
     DYN_BOOL_TO_STR,
     DYN_STR_TO_BOOL,
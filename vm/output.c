@@ -0,0 +1,244 @@
+/*
+ * Description: Output buffer module of the Chaos Programming Language's source
+ *
+ * Copyright (c) 2019-2021 Chaos Language Development Authority <info@chaos-lang.org>
+ *
+ * License: GNU General Public License v3.0
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors: M. Mert Yildiran <me@mertyildiran.com>
+ */
+
+#include "output.h"
+
+cpu_output_buffer* cpu_output = NULL;
+cpu_output_buffer* cpu_output_target = NULL;
+
+char cpu_output_json_escapes[256] = {
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't', 'n', 'u', 'f', 'r', 'u', 'u',
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+    0, 0, '"', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, '\\', 0, 0, 0
+};
+
+void init_cpu_output(bool line_buffered)
+{
+    if (cpu_output == NULL) {
+        cpu_output = malloc(sizeof(cpu_output_buffer));
+        cpu_output->arr = malloc(CPU_OUTPUT_BUFFER_SIZE * sizeof(char));
+        cpu_output->size = 0;
+        cpu_output->capacity = CPU_OUTPUT_BUFFER_SIZE;
+        cpu_output->stream = stdout;
+        cpu_output->flushed = 0;
+        cpu_output_target = cpu_output;
+
+        for (size_t i = 0; i < CPU_OUTPUT_INDENT_DEPTH; i++)
+            memcpy(cpu_output_indent_buffer + i * __KAOS_INDENT_LENGTH__, __KAOS_TAB__, __KAOS_INDENT_LENGTH__);
+    }
+    cpu_output->line_buffered = line_buffered;
+}
+
+void cpu_output_write(char* s, size_t len)
+{
+    if (cpu_output_target == NULL)
+        init_cpu_output(false);
+
+    cpu_output_buffer* buffer = cpu_output_target;
+    cpu_output_make_room(buffer, len);
+
+    // Writes that would not fit into an empty buffer either skip it
+    if (len > buffer->capacity - buffer->size) {
+        fwrite(s, sizeof(char), len, buffer->stream);
+        fflush(buffer->stream);
+        buffer->flushed += len;
+        return;
+    }
+
+    memcpy(buffer->arr + buffer->size, s, len * sizeof(char));
+    buffer->size += len;
+
+    if (buffer->line_buffered && memchr(s, '\n', len) != NULL)
+        cpu_output_flush();
+}
+
+void cpu_output_char(char c)
+{
+    cpu_output_write(&c, 1);
+}
+
+void cpu_output_str(char* s)
+{
+    cpu_output_write(s, strlen(s));
+}
+
+void cpu_output_indent(unsigned long depth)
+{
+    while (depth > CPU_OUTPUT_INDENT_DEPTH) {
+        cpu_output_write(cpu_output_indent_buffer, sizeof(cpu_output_indent_buffer));
+        depth -= CPU_OUTPUT_INDENT_DEPTH;
+    }
+    cpu_output_write(cpu_output_indent_buffer, depth * __KAOS_INDENT_LENGTH__);
+}
+
+char* cpu_output_reserve(size_t len)
+{
+    // Formatters write into the buffer directly, len has to fit into an empty buffer
+    if (cpu_output_target == NULL)
+        init_cpu_output(false);
+
+    cpu_output_make_room(cpu_output_target, len);
+    return cpu_output_target->arr + cpu_output_target->size;
+}
+
+void cpu_output_commit(size_t len)
+{
+    cpu_output_target->size += len;
+}
+
+void cpu_output_make_room(cpu_output_buffer* buffer, size_t len)
+{
+    if (buffer->size + len <= buffer->capacity)
+        return;
+
+    if (buffer->stream != NULL) {
+        fwrite(buffer->arr, sizeof(char), buffer->size, buffer->stream);
+        buffer->flushed += buffer->size;
+        buffer->size = 0;
+        return;
+    }
+
+    // String buffers grow, leaving room for the null-terminator
+    while (buffer->size + len + 1 > buffer->capacity)
+        buffer->capacity *= 2;
+    buffer->arr = realloc(buffer->arr, buffer->capacity * sizeof(char));
+}
+
+void cpu_output_flush()
+{
+    if (cpu_output == NULL)
+        return;
+
+    fwrite(cpu_output->arr, sizeof(char), cpu_output->size, cpu_output->stream);
+    fflush(cpu_output->stream);
+    cpu_output->flushed += cpu_output->size;
+    cpu_output->size = 0;
+}
+
+void free_cpu_output()
+{
+    if (cpu_output == NULL)
+        return;
+
+    cpu_output_flush();
+    free(cpu_output->arr);
+    free(cpu_output);
+    cpu_output = NULL;
+    cpu_output_target = NULL;
+}
+
+void cpu_exit(i64 status)
+{
+    cpu_output_flush();
+    exit((int)status);
+}
+
+cpu_output_buffer* new_cpu_output_string()
+{
+    if (cpu_output_target == NULL)
+        init_cpu_output(false);
+
+    cpu_output_buffer* buffer = malloc(sizeof(cpu_output_buffer));
+    buffer->arr = malloc(CPU_OUTPUT_STRING_MIN_CAPACITY * sizeof(char));
+    buffer->size = 0;
+    buffer->capacity = CPU_OUTPUT_STRING_MIN_CAPACITY;
+    buffer->line_buffered = false;
+    buffer->stream = NULL;
+    buffer->flushed = 0;
+    return buffer;
+}
+
+cpu_output_buffer* cpu_output_redirect(cpu_output_buffer* target)
+{
+    if (cpu_output_target == NULL)
+        init_cpu_output(false);
+
+    cpu_output_buffer* previous = cpu_output_target;
+    cpu_output_target = target;
+    return previous;
+}
+
+char* cpu_output_release_string(cpu_output_buffer* buffer)
+{
+    cpu_output_make_room(buffer, 1);
+    char* s = buffer->arr;
+    s[buffer->size] = '\0';
+    free(buffer);
+    return s;
+}
+
+cpu_output_buffer* new_cpu_output_stream(FILE* stream)
+{
+    cpu_output_buffer* buffer = new_cpu_output_string();
+    buffer->arr = realloc(buffer->arr, CPU_OUTPUT_BUFFER_SIZE * sizeof(char));
+    buffer->capacity = CPU_OUTPUT_BUFFER_SIZE;
+    buffer->stream = stream;
+    return buffer;
+}
+
+void cpu_output_release_stream(cpu_output_buffer* buffer)
+{
+    fwrite(buffer->arr, sizeof(char), buffer->size, buffer->stream);
+    fflush(buffer->stream);
+    free(buffer->arr);
+    free(buffer);
+}
+
+size_t cpu_output_length(cpu_output_buffer* buffer)
+{
+    return buffer->flushed + buffer->size;
+}
+
+void cpu_output_json_string(char* s, size_t len)
+{
+    cpu_output_char('"');
+
+    // Copy the runs of characters that need no escaping with a single write
+    size_t start = 0;
+    for (size_t i = 0; i < len; i++) {
+        char escape = cpu_output_json_escapes[(unsigned char)s[i]];
+        if (escape == 0)
+            continue;
+
+        cpu_output_write(s + start, i - start);
+        start = i + 1;
+
+        char* out = cpu_output_reserve(6);
+        out[0] = '\\';
+        out[1] = escape;
+        if (escape != 'u') {
+            cpu_output_commit(2);
+            continue;
+        }
+        out[2] = '0';
+        out[3] = '0';
+        out[4] = "0123456789abcdef"[(unsigned char)s[i] >> 4];
+        out[5] = "0123456789abcdef"[(unsigned char)s[i] & 0xf];
+        cpu_output_commit(6);
+    }
+    cpu_output_write(s + start, len - start);
+
+    cpu_output_char('"');
+}
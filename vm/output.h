@@ -0,0 +1,95 @@
+/*
+ * Description: Output buffer module of the Chaos Programming Language's source
+ *
+ * Copyright (c) 2019-2021 Chaos Language Development Authority <info@chaos-lang.org>
+ *
+ * License: GNU General Public License v3.0
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors: M. Mert Yildiran <me@mertyildiran.com>
+ */
+
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "types.h"
+#include "../utilities/language.h"
+
+/*
+  Everything print and echo write goes through a single output buffer
+  instead of a stdio call per scalar, bracket and separator. The buffer is
+  flushed when it is full, when the program ends or exits, before an error
+  is reported and whenever `cpu_output_flush` is called. In line buffered
+  mode, which the interactive shell opts in to, it is flushed after every
+  write that contains a newline as well.
+
+  The writes go to `cpu_output_target`, which is `cpu_output` unless it is
+  redirected to a string buffer or to a buffer of another stream. A string
+  buffer has no stream, it grows instead of being flushed, so values are
+  encoded into strings by the same code that prints them. `flushed` counts
+  what a stream buffer has written out so far, so the length of everything
+  written to a buffer is known without measuring it afterwards.
+*/
+#define CPU_OUTPUT_BUFFER_SIZE 65536
+#define CPU_OUTPUT_STRING_MIN_CAPACITY 64
+
+// Indentation is copied from a buffer of this many tabs at a time
+#define CPU_OUTPUT_INDENT_DEPTH 32
+
+typedef struct cpu_output_buffer {
+    char* arr;
+    size_t size;
+    size_t capacity;
+    bool line_buffered;
+    FILE* stream;
+    size_t flushed;
+} cpu_output_buffer;
+
+cpu_output_buffer* cpu_output;
+cpu_output_buffer* cpu_output_target;
+
+char cpu_output_indent_buffer[CPU_OUTPUT_INDENT_DEPTH * __KAOS_INDENT_LENGTH__];
+
+/*
+  JSON strings are escaped through a table that maps every byte to the
+  character after the backslash, 'u' for the control characters that are
+  written as \u00XX and 0 for the bytes that are copied as they are.
+*/
+char cpu_output_json_escapes[256];
+
+void init_cpu_output(bool line_buffered);
+void cpu_output_write(char* s, size_t len);
+void cpu_output_char(char c);
+void cpu_output_str(char* s);
+void cpu_output_indent(unsigned long depth);
+char* cpu_output_reserve(size_t len);
+void cpu_output_commit(size_t len);
+void cpu_output_make_room(cpu_output_buffer* buffer, size_t len);
+void cpu_output_flush();
+void free_cpu_output();
+void cpu_exit(i64 status);
+cpu_output_buffer* new_cpu_output_string();
+cpu_output_buffer* cpu_output_redirect(cpu_output_buffer* target);
+char* cpu_output_release_string(cpu_output_buffer* buffer);
+cpu_output_buffer* new_cpu_output_stream(FILE* stream);
+void cpu_output_release_stream(cpu_output_buffer* buffer);
+size_t cpu_output_length(cpu_output_buffer* buffer);
+void cpu_output_json_string(char* s, size_t len);
+
+#endif